@@ -2,36 +2,113 @@
 #define BOARD_HPP
 
 #include "Piece.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
-#include <string>
-#include <memory>
 
+/**
+ * @class Board
+ * @brief Compact, trivially copyable Squadro position.
+ *
+ * Every piece's track state is packed into a 4-bit "progress" value inside a single
+ * 64-bit word: 0-5 while travelling out, 6-12 on the way back (6 = just turned around,
+ * 12 = returned home). Copying a board is therefore a plain 24-byte copy.
+ *
+ * Alongside the Zobrist key, makeMove/unmakeMove keep the evaluation score and the number
+ * of pieces each player has brought home up to date, so neither needs a loop over the pieces.
+ */
 class Board {
 public:
     Board();
-    std::unique_ptr<Board> clone() const;
+    // Position with the given progress value (0-12) for every piece and `player` to move
+    static Board fromProgress(const std::array<int, 10>& progress, int player);
 
     // Game State Queries
-    bool isGameOver() const;
-    int getWinner() const;
+    bool isGameOver() const { return returned[0] >= PIECES_TO_WIN || returned[1] >= PIECES_TO_WIN; }
+    int getWinner() const {
+        if (returned[0] >= PIECES_TO_WIN) return 0;
+        if (returned[1] >= PIECES_TO_WIN) return 1;
+        return -1;
+    }
     int getCurrentPlayer() const;
     std::vector<int> getLegalMoves() const;
+    int getLegalMoveMask() const; // Bit k set when piece (first id of current player + k) may move
 
-    // --- NEW GETTER FOR AI EVALUATION ---
-    const std::vector<Piece>& getPieces() const;
+    // 64-bit Zobrist key of the position, maintained incrementally by makeMove/unmakeMove
+    std::uint64_t getHash() const { return hash_key; }
+    std::uint64_t computeHash() const; // Full recomputation from scratch
+
+    // --- GETTERS FOR AI EVALUATION ---
+    // Sum of progressScore over player 0's pieces minus the same over player 1's
+    int getScore() const { return score; }
+    int getReturnedCount(int player) const { return returned[player]; }
+    Piece getPiece(int pieceId) const;
+    std::array<Piece, 10> getPieces() const;
+    int getProgress(int pieceId) const {
+        return static_cast<int>((progress_bits >> (4 * pieceId)) & 0xF);
+    }
+
+    /**
+     * @brief Everything unmakeMove needs to take a move back. Jumped opponents are always
+     * reset to the start of their current leg, so their prior square follows from the mover's track.
+     */
+    struct MoveUndo {
+        std::uint8_t pieceId;
+        std::uint8_t fromProgress;
+        std::uint8_t resets;
+    };
 
     // Game Actions
-    void makeMove(int pieceId);
+    MoveUndo makeMove(int pieceId);
+    void unmakeMove(const MoveUndo& undo);
+
+    /**
+     * @brief Precomputed outcome of moving one piece: its new progress value and the
+     * bitmask of opponent tracks (bit k = track k+1) it jumps and sends back.
+     */
+    struct MoveTransition {
+        std::uint8_t destination;
+        std::uint8_t resets;
+    };
+    MoveTransition getMoveTransition(int pieceId) const;
+    // Table entry behind getMoveTransition: `occupancy` has bit k set when the opponent on
+    // track k+1 sits on the mover's lane
+    static MoveTransition lookupMoveTransition(int pieceId, int progress, int occupancy);
+
+    static constexpr int NUM_PIECES = 10;
+    static constexpr int PROGRESS_TURNED = 6;   // Progress value of a piece at the far side
+    static constexpr int PROGRESS_RETURNED = 12; // Progress value of a piece back home
+    static constexpr int PIECES_TO_WIN = 4;     // Returned pieces that win the game
+
+    // Evaluation worth of one piece: a square per step out, 10 for turning around plus two
+    // per step back, and 30 more once it is home
+    static constexpr int progressScore(int progress) {
+        if (!turnedOf(progress)) return progress;
+        int worth = (PROGRESS_TURNED - positionOf(progress)) * 2 + 10;
+        return progress == PROGRESS_RETURNED ? worth + 30 : worth;
+    }
+
+    static constexpr int positionOf(int progress) {
+        return progress <= PROGRESS_TURNED ? progress : PROGRESS_RETURNED - progress;
+    }
+    static constexpr bool turnedOf(int progress) { return progress >= PROGRESS_TURNED; }
 
 private:
-    std::vector<Piece> pieces;
+    std::uint64_t progress_bits; // 4 bits per piece, piece id i at bits [4i, 4i+4)
+    std::uint64_t hash_key;
     int currentPlayer;
+    std::int16_t score;        // See getScore()
+    std::uint8_t returned[2];  // Pieces at PROGRESS_RETURNED, by player
 
-    const std::vector<int> speeds_h = {1, 3, 2, 3, 1};
-    const std::vector<int> speeds_v = {3, 1, 2, 1, 3};
+    void setProgress(int pieceId, int progress); // Also updates hash_key, score and returned
 
-    int getPieceSpeed(const Piece& piece) const;
+    int crossingOccupancy(int pieceId) const;
     void switchPlayer();
+    void verifyIncrementalState() const; // Throws if hash_key, score or returned are out of sync
 };
 
+static_assert(std::is_trivially_copyable_v<Board>, "Board must stay a plain value type");
+static_assert(sizeof(Board) <= 64, "Board must fit in one cache line");
+
 #endif // BOARD_HPP
@@ -0,0 +1,31 @@
+#ifndef ENGINE_DATA_HPP
+#define ENGINE_DATA_HPP
+
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Written by tools/tb_gen and tools/book_gen; looked for in the working directory
+inline const char* const TABLEBASE_PATH = "squadro.tb";
+inline const char* const OPENING_BOOK_PATH = "squadro.book";
+
+// Loads an optional engine data file (Tablebase, OpeningBook) if it exists, else returns
+// null. A file that fails to load is reported and ignored: without it every position is
+// simply searched.
+template<class Data>
+std::shared_ptr<const Data> loadOptional(const std::string& path, const char* description) {
+    if (!std::filesystem::exists(path)) return nullptr;
+    try {
+        auto data = std::make_shared<Data>();
+        data->load(path);
+        std::cout << "Loaded " << description << " with " << data->size() << " entries.\n";
+        return data;
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring " << description << ": " << e.what() << '\n';
+        return nullptr;
+    }
+}
+
+#endif // ENGINE_DATA_HPP
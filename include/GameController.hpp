@@ -2,11 +2,15 @@
 #define GAME_CONTROLLER_HPP
 
 #include "Board.hpp"
-#include "MinimaxAI.hpp"
+#include "MoveSender.hpp"
+#include "SearchEngine.hpp"
+#include "TimeManager.hpp"
 #include <string>
 #include <chrono>
+#include <memory>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 
 // Forward declaration for httplib
 namespace httplib { class Server; }
@@ -17,27 +21,38 @@ namespace httplib { class Server; }
  */
 class GameController {
 public:
-    GameController(const std::string& host, int send_port, int receive_port, int ai_player_id);
+    enum class EngineType { Minimax, Mcts };
+
+    GameController(const std::string& host, int send_port, int receive_port, int ai_player_id,
+                   EngineType engine = EngineType::Minimax, const TimeControl& time_control = {},
+                   const HttpClientOptions& http = {});
     ~GameController();
 
     // The main game loop for the AI bot.
     void run();
+    // Ends the game from any thread: a search in progress is stopped and run() returns
+    void stop();
     
 private:
     Board board;
-    MinimaxAI ai;
+    std::unique_ptr<SearchEngine> ai;
     
     std::string host_ip;
     int port_to_send;
     int port_to_receive;
     int ai_player;
-    const std::chrono::duration<double> move_time_limit{10};
-    bool ai_moved_this_turn = false;
+    TimeManager time_manager; // Only used by the thread running run()
+    bool ai_moved_this_turn = false; // Guarded by board_mutex
+    bool stopped = false;            // Guarded by board_mutex
+
+    // Long-lived client for sending our moves, reused across turns
+    MoveSender sender;
 
     // HTTP Server to listen for opponent moves
     std::unique_ptr<httplib::Server> svr;
     std::thread server_thread;
     mutable std::mutex board_mutex; // Protects the board from simultaneous access
+    std::condition_variable board_changed; // Signalled by the move handler to wake run()
 
     void startListeningServer();
     void makeAndSendAIMove();
@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file.
+ *
+ * On POSIX systems the file is mapped with mmap(MAP_SHARED), so pages are only read from
+ * disk when first touched and every process mapping the same file shares one page-cache
+ * copy. Elsewhere the file is read into memory.
+ */
+class MappedFile {
+public:
+    // `random_access` hints that reads will be scattered, so read-ahead would only waste memory
+    explicit MappedFile(const std::string& path, bool random_access = true); // Throws std::runtime_error
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return bytes; }
+    std::size_t size() const { return length; }
+
+private:
+    const unsigned char* bytes = nullptr;
+    std::size_t length = 0;
+    std::vector<unsigned char> buffer; // File contents where mapping is not available
+};
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,79 @@
+#ifndef MCTS_AI_HPP
+#define MCTS_AI_HPP
+
+#include "Board.hpp"
+#include "Playout.hpp"
+#include "SearchEngine.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @class MctsAI
+ * @brief Tree-parallel Monte Carlo Tree Search engine using UCT selection and random playouts.
+ *
+ * Every pool worker descends the same tree at once. There is no lock: node statistics are
+ * atomic counters, and a thread adds a virtual loss to each node it passes so the threads
+ * behind it are steered onto other paths until its playout result is backed up.
+ *
+ * Nodes live in one preallocated arena and the children of a node are created together,
+ * so they sit next to each other and are addressed by the index of the first one. Nodes
+ * store no board: each iteration replays the moves of its path onto a copy of the root.
+ * When the arena is full the tree stops growing and further playouts start from its leaves.
+ */
+class MctsAI : public SearchEngine {
+public:
+    // `max_playouts` bounds the search in addition to the clock; 0 means the clock alone
+    MctsAI(std::size_t num_threads = 0, std::size_t tree_size_mb = 64, std::size_t max_playouts = 0,
+           double exploration = 1.4);
+    int findBestMove(const Board& board, const MoveBudget& budget) override;
+    // Stops the search in progress, or the next one if none is running
+    void stop() override;
+
+private:
+    // A thread passing through a node counts as this many lost playouts until it backs up its result
+    static constexpr std::uint32_t VIRTUAL_LOSS = 3;
+
+    struct Node {
+        enum State : std::uint8_t { Leaf, Expanding, Expanded };
+
+        std::atomic<std::uint32_t> visits{0}; // Includes the virtual losses of threads below
+        std::atomic<std::uint32_t> wins{0};   // Playouts won by the player who made `move`
+        std::uint32_t first_child = 0;        // Index of the first child, valid once Expanded
+        std::int8_t move = -1;                // Piece id moved to reach this node
+        std::uint8_t num_children = 0;
+        std::atomic<std::uint8_t> state{Leaf};
+
+        void reset(int piece_id);
+    };
+
+    // Scratch state owned by one searching thread
+    struct Worker {
+        std::vector<std::uint32_t> path; // Nodes visited by the current iteration, root first
+        Xoshiro256& rng = threadRng();
+    };
+
+    ThreadPool pool;
+    std::atomic<bool> stop_search{false}; // Raised by the first worker to find the clock run out
+    StopRequests stop_requests; // Counted by stop(); every findBestMove holds a StopRequests::Scope
+
+    std::unique_ptr<Node[]> nodes;
+    std::size_t capacity;
+    std::atomic<std::size_t> node_count{0};
+
+    std::size_t max_playouts;
+    double exploration;
+
+    bool stopRequested() const;
+    // Runs one selection/expansion/simulation/backpropagation cycle from the root
+    void runIteration(const Board& root, Worker& worker);
+    std::uint32_t selectChild(const Node& parent) const;
+    bool expand(Node& node, const Board& board); // False if another thread got there first or the arena is full
+    void backpropagate(const std::vector<std::uint32_t>& path, int winner, int root_player);
+};
+
+#endif // MCTS_AI_HPP
@@ -2,30 +2,173 @@
 #define MINIMAX_AI_HPP
 
 #include "Board.hpp"
+#include "MoveOrdering.hpp"
+#include "OpeningBook.hpp"
+#include "SearchEngine.hpp"
+#include "Tablebase.hpp"
 #include "ThreadPool.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 /**
  * @class MinimaxAI
- * @brief Implements the AI logic using Iterative Deepening Minimax with Alpha-Beta Pruning.
+ * @brief Implements the AI logic using Iterative Deepening negamax Principal Variation Search
+ * with aspiration windows and a transposition table.
  */
-class MinimaxAI {
+class MinimaxAI : public SearchEngine {
 public:
-    MinimaxAI(size_t num_threads = 0);
-    int findBestMove(const Board& board, const std::chrono::duration<double>& time_limit);
+    /**
+     * @brief How the search is spread over the thread pool.
+     *
+     * RootSplit: one pool task per root move, each searched with a full window.
+     * LazySmp:   the calling thread runs iterative deepening while every pool worker runs
+     *            its own staggered iterative deepening over the shared transposition table;
+     *            only the calling thread's result is used.
+     * SplitPoint: Young Brothers Wait. At nodes deep enough to be worth it the first child is
+     *            searched alone, then the remaining siblings are shared out to pool workers
+     *            with the bound it established; a cutoff cancels the siblings still running.
+     * Sequential: iterative deepening entirely in the calling thread; the engine starts no
+     *            threads of its own, so many engines can run side by side on one shared pool.
+     */
+    enum class SearchMode { RootSplit, LazySmp, SplitPoint, Sequential };
+
+    MinimaxAI(size_t num_threads = 0, size_t tt_size_mb = 64, SearchMode mode = SearchMode::RootSplit);
+    // Searches into a table shared with other engines, e.g. one per game of a session server.
+    // Table statistics then cover every engine, so they are not reset or reported per search,
+    // and the table is not aged per search either: whoever shares it calls newSearch().
+    explicit MinimaxAI(std::shared_ptr<TranspositionTable> table, size_t num_threads = 0,
+                       SearchMode mode = SearchMode::Sequential);
+    ~MinimaxAI() override;
+    int findBestMove(const Board& board, const MoveBudget& budget) override;
+
+    // Pondering runs the normal search on a background thread; all it leaves behind is the
+    // transposition table, which the next findBestMove reuses
+    void startPondering(const Board& board) override;
+    void stopPondering() override;
+
+    // Makes the search in progress, on any thread, return its best completed move at once.
+    // With no search in progress, the next one to start returns at once instead.
+    void stop() override;
+
+    // Positions the tablebase covers get their exact value instead of being searched
+    void setTablebase(std::shared_ptr<const Tablebase> tablebase);
+    // A trusted book move is played at once, without searching
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book);
+    // Blends each root move's score with random playouts from it, as the original engine did.
+    // On by default in RootSplit, the only mode that searches each root move to an exact score;
+    // other modes reject it with std::invalid_argument. Turn it off to compare modes on search alone.
+    void setRolloutBlend(bool enabled);
 
 private:
-    // The recursive Minimax function. Note the const Board& to avoid copying.
-    int minimax(const Board& board, int depth, bool isMaximizingPlayer,
-        int alpha, int beta,
+    // Dispatches to the search of the configured mode. A ponder search searches the
+    // opponent's move and only fills the table, so it reports nothing and skips the
+    // rollout blend, whose root scores it would throw away.
+    int runSearch(const Board& board, const MoveBudget& budget,
+                  const std::chrono::steady_clock::time_point& start_time, bool pondering);
+    int findBestMoveRootSplit(const Board& board, const MoveBudget& budget,
+                              const std::chrono::steady_clock::time_point& start_time, bool pondering);
+    int findBestMoveLazySmp(const Board& board, const MoveBudget& budget,
+                            const std::chrono::steady_clock::time_point& start_time, bool pondering);
+
+    // Iterative deepening over searchRoot in the calling thread; aborted iterations are dropped.
+    // Searches below the root only see the budget's maximum, as the hard time limit. Depth 1
+    // has no time limit, so the clock never leaves it without a searched move; only a stop()
+    // arriving before depth 1 completes falls back to the first legal move.
+    int iterativeDeepening(const Board& board, const MoveBudget& budget,
+                           const std::chrono::steady_clock::time_point& start_time, bool pondering);
+
+    // Scores are negamax scores: relative to the side to move, within +/-SCORE_INFINITY
+    static constexpr int SCORE_INFINITY = 1000000;
+    static constexpr int WIN_SCORE = 1000;         // Score of a won game, as returned by evaluateState
+    static constexpr int ASPIRATION_WINDOW = 10;   // Initial half-width around the previous score
+    static constexpr int ASPIRATION_MIN_DEPTH = 4; // Shallower iterations use a full window
+    static constexpr std::chrono::hours NO_TIME_LIMIT{24}; // For depth 1, Lazy SMP helpers and pondering
+
+    // Searches every root move within (alpha, beta). Non-hash root moves are tried
+    // starting from index `rotation` so Lazy SMP helpers diverge from each other.
+    int searchRoot(Board& board, MoveOrdering& ordering, int depth, int rotation, int alpha, int beta, int& bestMove,
+                   const std::chrono::steady_clock::time_point&,
+                   const std::chrono::duration<double>&);
+
+    // Shared state of a node whose younger siblings are being searched in parallel
+    struct SplitPoint;
+    static constexpr int MIN_SPLIT_DEPTH = 4; // Shallower subtrees are not worth a pool task
+
+    // The recursive negamax Principal Variation Search. Each search thread owns one mutable
+    // board that is walked with makeMove/unmakeMove, so no board is copied below the root.
+    // `ply` is the distance from the root, used to index killer moves.
+    int negamax(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
         const std::chrono::steady_clock::time_point&,
-        const std::chrono::duration<double>&);
-    ThreadPool pool; // Member variable for the thread pool
+        const std::chrono::duration<double>&,
+        const SplitPoint* parent = nullptr);
+
+    // Searches the ordered moves one after another, PVS style
+    int searchMoves(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                    const int order[5], int count, int& bestMove, const SplitPoint* parent,
+                    const std::chrono::steady_clock::time_point&,
+                    const std::chrono::duration<double>&);
+    // Scores the child position already made on `board`: with the full window for the
+    // first move, otherwise with a null window and a full re-search if it lands inside
+    int searchChild(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                    bool firstMove, const SplitPoint* parent,
+                    const std::chrono::steady_clock::time_point&,
+                    const std::chrono::duration<double>&);
+
+    // Searches order[0] alone, then splits the remaining moves over the pool (SplitPoint mode)
+    int searchSplitPoint(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                         const int order[5], int count, int& bestMove, const SplitPoint* parent,
+                         const std::chrono::steady_clock::time_point&,
+                         const std::chrono::duration<double>&);
+    // Claims and searches siblings of `sp` until none are left
+    void helpSplitPoint(SplitPoint& sp, Board& board, MoveOrdering& ordering,
+                        const std::chrono::steady_clock::time_point&,
+                        const std::chrono::duration<double>&);
+    // True if a cutoff at `sp` or any split point above it made the current work pointless
+    static bool cutoffOccurred(const SplitPoint* sp);
+
+    std::unique_ptr<ThreadPool> pool; // Not created in Sequential mode
+
+    // Shared by every pool worker; lock-free, so any thread may probe or store at any time
+    std::shared_ptr<TranspositionTable> tt;
+    bool shared_table = false; // Other engines search into `tt` too
+
+    SearchMode search_mode;
+    bool rollout_blend;
+    static constexpr int BLEND_ROLLOUTS = 500; // Playouts per root move and depth when blending
+    std::shared_ptr<const Tablebase> tablebase; // Read-only, so shared by all threads without locking
+    std::shared_ptr<const OpeningBook> opening_book;
+
+    // Observed by every thread of the running search. Raised by the first thread to find the
+    // clock run out, by stopPondering(), and when the main Lazy SMP search finishes so its
+    // helpers return; lowered when the next search starts. Only the engine itself raises it.
+    std::atomic<bool> stop_search{false};
+    // Counted by stop(); every findBestMove and ponder search holds a StopRequests::Scope
+    StopRequests stop_requests;
+    static constexpr std::uint32_t CLOCK_CHECK_INTERVAL = 1024; // shouldStop calls per clock read, per thread
+
+    std::mutex ponder_mutex;               // Serialises starting and stopping the ponder thread
+    std::thread ponder_thread;
+    void stopPonderingLocked();
+
+    bool stopRequested() const;
+    // True once the search has been stopped; polls the clock every CLOCK_CHECK_INTERVAL calls
+    bool shouldStop(const std::chrono::steady_clock::time_point& start_time,
+                    const std::chrono::duration<double>& time_limit);
 
+    // Ordering state of the calling thread, kept across searches and aged between them
+    MoveOrdering main_ordering;
 
     int mctsRollout(const Board& board, int num_simulations) const;
     
     int evaluateState(const Board& board) const;
+    int evaluateForSideToMove(const Board& board) const;
+    // Negamax score of a tablebase distance to mate: faster wins and slower losses score higher
+    static int tablebaseScore(int distance);
 };
 
 #endif // MINIMAX_AI_HPP
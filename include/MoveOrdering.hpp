@@ -0,0 +1,39 @@
+#ifndef MOVE_ORDERING_HPP
+#define MOVE_ORDERING_HPP
+
+#include "Board.hpp"
+
+/**
+ * @class MoveOrdering
+ * @brief Per-thread move ordering state for the alpha-beta search.
+ *
+ * Moves are tried as: transposition table move, moves that jump opponents (most jumps
+ * first), the two killer moves of the current ply, then the rest by history score.
+ * Each search thread owns its own instance, so none of this is shared or locked.
+ */
+class MoveOrdering {
+public:
+    static constexpr int MAX_PLY = 64;
+
+    MoveOrdering();
+
+    void clear();
+    void age(); // Forgets killers and halves history so a new search favours fresh information
+
+    // Fills `order` with the legal moves of `board` in search order and returns how many there
+    // are. Moves that score equally keep their id order, rotated to start at `rotation`.
+    int orderMoves(const Board& board, int hash_move, int ply, int rotation, int order[5]) const;
+
+    // Rewards `move` for causing a beta cutoff at `ply` in a search of the given depth
+    void recordCutoff(const Board& board, int move, int ply, int depth);
+
+private:
+    static constexpr int HISTORY_LIMIT = 1 << 16;
+
+    int killers[MAX_PLY][2];
+    int history[Board::NUM_PIECES][Board::PROGRESS_RETURNED + 1]; // By piece and its progress before moving
+
+    void halveHistory();
+};
+
+#endif // MOVE_ORDERING_HPP
@@ -0,0 +1,46 @@
+#ifndef MOVE_SENDER_HPP
+#define MOVE_SENDER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Forward declaration for httplib
+namespace httplib { class Client; }
+
+// How moves are sent to the GUI: one keep-alive connection, retried on transient failures
+struct HttpClientOptions {
+    std::chrono::milliseconds connection_timeout{2000};
+    std::chrono::milliseconds read_timeout{5000};
+    int max_retries = 3;                                // Extra attempts after the first
+    std::chrono::milliseconds retry_backoff{50};        // Doubled after every failed attempt
+};
+
+/**
+ * @class MoveSender
+ * @brief Long-lived HTTP client that posts our moves to the GUI and records their latency.
+ *
+ * Safe to share between threads: requests go out one at a time over the same connection.
+ */
+class MoveSender {
+public:
+    MoveSender(const std::string& host, int port, const HttpClientOptions& options = {});
+    ~MoveSender();
+
+    // Posts `json_string` to `path`; true once the GUI has accepted it
+    bool send(const std::string& path, const std::string& json_string);
+
+private:
+    HttpClientOptions options;
+    std::mutex client_mutex; // Guards cli and the statistics
+    std::unique_ptr<httplib::Client> cli;
+
+    // Round-trip times of the moves sent so far, retries included
+    std::size_t requests = 0;
+    std::chrono::duration<double, std::milli> total_latency{0};
+    std::chrono::duration<double, std::milli> max_latency{0};
+};
+
+#endif // MOVE_SENDER_HPP
@@ -0,0 +1,49 @@
+#ifndef OPENING_BOOK_HPP
+#define OPENING_BOOK_HPP
+
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class OpeningBook
+ * @brief Move statistics from self-play for early positions, keyed by Board::getHash().
+ *
+ * The file is a header followed by entries sorted by (key, move), one per position and
+ * move played from it. It is memory-mapped like the tablebase and probed by binary search.
+ */
+class OpeningBook {
+public:
+    struct Entry {
+        std::uint64_t key;
+        std::uint32_t games; // Self-play games in which `move` was played here
+        std::uint32_t wins;  // Of those, games won by the side that played it
+        std::int32_t move;   // Piece id
+        std::uint32_t reserved;
+    };
+    static_assert(sizeof(Entry) == 24, "Entry is stored on disk as is");
+
+    // A book move is only trusted with at least this much evidence behind it
+    static constexpr std::uint32_t MIN_GAMES = 8;
+    static constexpr double MIN_WIN_RATE = 0.5;
+
+    OpeningBook() = default;
+
+    void load(const std::string& path); // Throws std::runtime_error if missing or malformed
+    static void save(const std::string& path, std::vector<Entry> entries); // Sorts the entries first
+
+    // The most played move from this position if it is trusted, else -1
+    int probe(const Board& board) const;
+
+    std::size_t size() const { return entry_count; }
+
+private:
+    std::unique_ptr<MappedFile> file;
+    const Entry* entries = nullptr;
+    std::size_t entry_count = 0;
+};
+
+#endif // OPENING_BOOK_HPP
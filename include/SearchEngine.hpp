@@ -0,0 +1,63 @@
+#ifndef SEARCH_ENGINE_HPP
+#define SEARCH_ENGINE_HPP
+
+#include "Board.hpp"
+#include "TimeManager.hpp"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class SearchEngine
+ * @brief Common interface of the move-choosing engines, so GameController can drive any of them.
+ */
+class SearchEngine {
+public:
+    virtual ~SearchEngine() = default;
+
+    // Returns the piece id to move for the side to move, or -1 if it has no legal move.
+    // A plain duration may be passed as the budget when there is no time to save.
+    virtual int findBestMove(const Board& board, const MoveBudget& budget) = 0;
+
+    // Searches `board` (the opponent to move) in the background until stopPondering() or the
+    // next findBestMove, so that search starts from what was learnt on the opponent's time.
+    // Engines that have nothing to carry over between moves ignore these.
+    virtual void startPondering(const Board&) {}
+    virtual void stopPondering() {}
+
+    // Asks the search in progress, from any thread, to return its best move so far right away
+    virtual void stop() = 0;
+};
+
+/**
+ * @class StopRequests
+ * @brief Counts stop() calls against the search they are meant for.
+ *
+ * A search is cancelled once the count differs from the one it was armed with, taken when the
+ * previous search ended, so a stop() that lands between two searches cancels the next one
+ * rather than being lost.
+ */
+class StopRequests {
+public:
+    void request() { count.fetch_add(1, std::memory_order_relaxed); }
+    bool pending() const {
+        return count.load(std::memory_order_relaxed) != armed.load(std::memory_order_relaxed);
+    }
+
+    // Re-arms when it goes out of scope, however the search returns: requests made up to then
+    // were for that search, later ones are for the next
+    class Scope {
+    public:
+        explicit Scope(StopRequests& requests) : requests(requests) {}
+        ~Scope() { requests.armed.store(requests.count.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        StopRequests& requests;
+    };
+
+private:
+    std::atomic<std::uint64_t> count{0};
+    std::atomic<std::uint64_t> armed{0};
+};
+
+#endif // SEARCH_ENGINE_HPP
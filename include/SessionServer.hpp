@@ -0,0 +1,101 @@
+#ifndef SESSION_SERVER_HPP
+#define SESSION_SERVER_HPP
+
+#include "Board.hpp"
+#include "MinimaxAI.hpp"
+#include "MoveSender.hpp"
+#include "OpeningBook.hpp"
+#include "Tablebase.hpp"
+#include "ThreadPool.hpp"
+#include "TimeManager.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Forward declaration for httplib
+namespace httplib { class Server; }
+
+/**
+ * @class SessionServer
+ * @brief Plays many games at once from one process, each identified by a game ID.
+ *
+ * Protocol, on the receive port:
+ *   POST /games/<id>/start {"player": p}  starts a game in which the bot is player p (1 or 2)
+ *   POST /games/<id> {"move": m, "player": p}  the opponent's move, as in the single-game mode
+ *   DELETE /games/<id>                     abandons a game
+ * Our moves are posted to /games/<id> on the send port as {"move": m}. A game whose move
+ * still cannot be delivered after the sender's retries is abandoned, as if deleted.
+ *
+ * Every game has its own board and a Sequential MinimaxAI, but all of them search into one
+ * shared transposition table, aged once every game has had about one search. Each search is a single task on one shared thread pool, queued
+ * in the order the moves came in: games are served first come, first served, one core each,
+ * and time spent waiting in the queue is charged to that game's clock.
+ *
+ * So that a game at the back of the queue still has time to search, a search started while
+ * more games are waiting for a move than there are threads only gets its share of the time
+ * left: threads / waiting games of it. No search gets less than MIN_SEARCH_TIME, and the
+ * engine always completes depth 1, so every move sent has been searched.
+ */
+class SessionServer {
+public:
+    SessionServer(const std::string& host, int send_port, int receive_port,
+                  size_t num_threads = 0, size_t tt_size_mb = 256, const TimeControl& time_control = {},
+                  const HttpClientOptions& http = {});
+    ~SessionServer();
+
+    // Serves games until stop() is called
+    void run();
+    void stop();
+
+private:
+    struct Game {
+        std::mutex mutex; // Guards board
+        Board board;
+        int ai_player;    // 1 or 2
+        MinimaxAI ai;
+        TimeManager time_manager; // Only used by the search task, one at a time
+        MoveSender sender; // Its own connection, so a slow reply to one game holds up no other
+        std::atomic<bool> abandoned{false}; // Deleted or shut down: no more moves are played
+
+        Game(int player, std::shared_ptr<TranspositionTable> table, const TimeControl& time_control,
+             const std::string& host, int send_port, const HttpClientOptions& http)
+            : ai_player(player), ai(std::move(table)), time_manager(time_control),
+              sender(host, send_port, http) {}
+    };
+
+    static constexpr std::chrono::milliseconds MIN_SEARCH_TIME{50};
+
+    std::string host_ip;
+    int port_to_send;
+    int port_to_receive;
+    HttpClientOptions http_options;
+    TimeControl time_control; // Every game is played under the same clock
+    std::atomic<size_t> waiting_games{0}; // Games whose search is queued or running
+    std::atomic<size_t> searches_this_round{0}; // Searches since the table was last aged
+
+    std::shared_ptr<TranspositionTable> tt;
+    std::shared_ptr<const Tablebase> tablebase;
+    std::shared_ptr<const OpeningBook> opening_book;
+
+    std::mutex games_mutex; // Guards games
+    std::unordered_map<std::string, std::shared_ptr<Game>> games;
+
+    std::unique_ptr<httplib::Server> svr;
+    ThreadPool pool; // Declared last so queued searches finish before anything they use goes
+
+    std::shared_ptr<Game> findGame(const std::string& id);
+    void removeGame(const std::string& id);
+    // Queues a search for our move in `game`; the clock starts now, not when the search does
+    void scheduleMove(const std::string& id, std::shared_ptr<Game> game);
+    void playMove(const std::string& id, Game& game, std::chrono::steady_clock::time_point queued_at);
+    // Counts a finished search and ages the shared table once per round of them
+    void endSearch();
+    // What is left of a game's budget after `waited` in the queue, shared with the games waiting
+    MoveBudget shareBudget(MoveBudget budget, std::chrono::duration<double> waited) const;
+};
+
+#endif // SESSION_SERVER_HPP
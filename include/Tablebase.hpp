@@ -0,0 +1,80 @@
+#ifndef TABLEBASE_HPP
+#define TABLEBASE_HPP
+
+#include "Board.hpp"
+#include "MappedFile.hpp"
+#include <array>
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class Tablebase
+ * @brief Endgame tablebase solved by retrograde analysis.
+ *
+ * Positions are grouped into classes by which pieces are still on the board (not yet
+ * returned home). A tablebase covers every class in which each side has between 2 and
+ * `max_unfinished` pieces left; a side with a single piece left has already lost. Within a
+ * class a position is indexed by the side to move and the progress (0-11) of each
+ * unfinished piece, read as a mixed-radix number after the class's offset.
+ *
+ * That index is a minimal perfect hash of the packed position, so a probe is one byte read.
+ *
+ * Each entry is the distance to mate in plies from the side to move's view: n > 0 wins in
+ * n, n < 0 loses in -n, 0 is a draw. A position still unresolved when the distances run out
+ * of int8 range is stored as UNKNOWN and is not covered: probes of it return false.
+ *
+ * A loaded tablebase is memory-mapped and probed in place: nothing is copied at load time,
+ * pages are read on first use, and bots on one host share a single page-cache copy.
+ */
+class Tablebase {
+public:
+    static constexpr int DEFAULT_MAX_UNFINISHED = 2;
+
+    Tablebase() = default;
+
+    // Entries may point into `owned`, so copies would dangle
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+    // Solves every covered position from scratch, reporting each sweep to `log` if given
+    void generate(int max_unfinished = DEFAULT_MAX_UNFINISHED, std::ostream* log = nullptr);
+
+    void save(const std::string& path) const;
+    void load(const std::string& path); // Maps the file; throws std::runtime_error if missing or malformed
+
+    // Fills `distance` and returns true if the position is covered and resolved
+    bool probe(const Board& board, int& distance) const;
+
+    bool empty() const { return entry_count == 0; }
+    std::size_t size() const { return entry_count; }
+
+private:
+    static constexpr int PROGRESS_RADIX = Board::PROGRESS_RETURNED; // Progress values 0-11 of an unfinished piece
+    static constexpr std::int8_t UNKNOWN = std::numeric_limits<std::int8_t>::min(); // Beyond the horizon
+    static constexpr int MAX_DISTANCE = std::numeric_limits<std::int8_t>::max();    // The horizon, in plies
+
+    struct PositionClass {
+        std::uint8_t unfinished[2]; // Bit k set when piece k of that player is still on the board
+        std::uint64_t offset;       // Index of the class's first position
+    };
+
+    int max_unfinished = 0;
+    std::vector<PositionClass> classes;
+    std::array<std::int32_t, 32 * 32> class_of{}; // Class number by unfinished masks, -1 if not covered
+
+    // Entries live either in `owned` (generated here) or in `file` (loaded)
+    std::vector<std::int8_t> owned;
+    std::unique_ptr<MappedFile> file;
+    const std::int8_t* entries = nullptr;
+    std::size_t entry_count = 0;
+
+    std::uint64_t buildClasses(int max_unfinished); // Returns the total number of positions
+    bool indexOf(const Board& board, std::uint64_t& index) const;
+    Board positionAt(std::uint64_t index) const;
+};
+
+#endif // TABLEBASE_HPP
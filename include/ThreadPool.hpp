@@ -1,86 +1,379 @@
 #ifndef POOL
 #define POOL
 
-#include <vector>
-#include <queue>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <new>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+/**
+ * @class ThreadPool
+ * @brief Work-stealing thread pool.
+ *
+ * Every worker owns a bounded deque: it pushes and pops its own tasks at the back (LIFO,
+ * cache friendly) while idle workers steal from the front of others' deques. Tasks
+ * submitted from outside the pool go through a shared injection queue. Tasks are stored
+ * in a small-buffer Task type, so submitting a small closure from a worker allocates nothing.
+ *
+ * TaskGroup gives fork-join parallelism: wait() runs queued tasks instead of blocking, so a
+ * task may itself fork and wait on a group without tying up its worker.
+ */
 class ThreadPool {
 public:
+    /**
+     * @class Task
+     * @brief Move-only type-erased void() callable stored inline when it fits.
+     */
+    class Task {
+    public:
+        static constexpr std::size_t INLINE_SIZE = 48;
+
+        Task() = default;
+
+        template<class F, class = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+        Task(F&& f) {
+            using Fn = std::decay_t<F>;
+            if constexpr (fitsInline<Fn>()) {
+                new (storage) Fn(std::forward<F>(f));
+                ops = &inline_ops<Fn>;
+            } else {
+                new (storage) Fn*(new Fn(std::forward<F>(f)));
+                ops = &heap_ops<Fn>;
+            }
+        }
+
+        Task(Task&& other) noexcept : ops(other.ops) {
+            if (ops) {
+                ops->move(storage, other.storage);
+                other.ops = nullptr;
+            }
+        }
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                reset();
+                ops = other.ops;
+                if (ops) {
+                    ops->move(storage, other.storage);
+                    other.ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() { reset(); }
+
+        void operator()() { ops->invoke(storage); }
+        explicit operator bool() const { return ops != nullptr; }
+
+    private:
+        struct Ops {
+            void (*invoke)(void*);
+            void (*move)(void* dst, void* src) noexcept; // Move-constructs dst and destroys src
+            void (*destroy)(void*) noexcept;
+        };
+
+        template<class Fn>
+        static constexpr bool fitsInline() {
+            return sizeof(Fn) <= INLINE_SIZE && alignof(Fn) <= alignof(std::max_align_t)
+                && std::is_nothrow_move_constructible_v<Fn>;
+        }
+
+        template<class Fn>
+        static constexpr Ops inline_ops = {
+            [](void* p) { (*static_cast<Fn*>(p))(); },
+            [](void* dst, void* src) noexcept {
+                new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+                static_cast<Fn*>(src)->~Fn();
+            },
+            [](void* p) noexcept { static_cast<Fn*>(p)->~Fn(); }
+        };
+
+        template<class Fn>
+        static constexpr Ops heap_ops = {
+            [](void* p) { (**static_cast<Fn**>(p))(); },
+            [](void* dst, void* src) noexcept { new (dst) Fn*(*static_cast<Fn**>(src)); },
+            [](void* p) noexcept { delete *static_cast<Fn**>(p); }
+        };
+
+        void reset() {
+            if (ops) {
+                ops->destroy(storage);
+                ops = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+        const Ops* ops = nullptr;
+    };
+
+    /**
+     * @class TaskGroup
+     * @brief Fork-join scope: run() forks tasks into the pool, wait() helps execute queued
+     * work until all of them have finished and rethrows the first exception any of them threw.
+     */
+    class TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+        ~TaskGroup() {
+            // Tasks reference this group, so they must be finished before it goes away
+            try { wait(); } catch (...) {}
+        }
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template<class F>
+        void run(F&& f) {
+            pending.fetch_add(1, std::memory_order_relaxed);
+            pool.submit([this, fn = std::forward<F>(f)]() mutable {
+                try {
+                    fn();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(error_mutex);
+                    if (!error) error = std::current_exception();
+                }
+                finishTask();
+            });
+        }
+
+        // Helps with queued work while the group's tasks run. With nothing to help with it
+        // yields for a while, as siblings usually finish soon, then sleeps until the last task
+        // finishes or new work is queued rather than keep a core busy.
+        void wait() {
+            int idle = 0;
+            while (pending.load(std::memory_order_acquire) != 0) {
+                if (pool.runPendingTask()) {
+                    idle = 0;
+                } else if (++idle < SPIN_LIMIT) {
+                    std::this_thread::yield();
+                } else {
+                    pool.sleepUntilJoined(*this);
+                    idle = 0;
+                }
+            }
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (error) std::rethrow_exception(std::exchange(error, nullptr));
+        }
+
+    private:
+        friend class ThreadPool;
+        static constexpr int SPIN_LIMIT = 64; // Idle yields in wait() before it sleeps
+
+        ThreadPool& pool;
+        std::atomic<int> pending{0};
+        bool sleeping = false; // The owner is asleep in wait(); guarded by the pool's sleep_mutex
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        void finishTask() {
+            // Any task but the last just leaves. The group may be destroyed as soon as
+            // `pending` reaches zero, so nothing here touches it after that decrement.
+            for (int left = pending.load(); left > 1; ) {
+                if (pending.compare_exchange_weak(left, left - 1, std::memory_order_release)) return;
+            }
+            pool.finishLastTask(*this);
+        }
+    };
+
     // Constructor initializes and starts a number of worker threads
-    ThreadPool(size_t threads) : stop(false) {
+    ThreadPool(size_t threads) {
         if (threads == 0) {
             threads = std::thread::hardware_concurrency();
             if (threads == 0) {
                 threads = 4; // Default to 4 if hardware_concurrency() fails
             }
         }
-        for(size_t i = 0; i < threads; ++i) {
-            workers.emplace_back(
-                [this] {
-                    for(;;) {
-                        std::function<void()> task;
-                        {
-                            std::unique_lock<std::mutex> lock(this->queue_mutex);
-                            this->condition.wait(lock,
-                                [this]{ return this->stop || !this->tasks.empty(); });
-                            if(this->stop && this->tasks.empty())
-                                return;
-                            task = std::move(this->tasks.front());
-                            this->tasks.pop();
-                        }
-                        task();
-                    }
-                }
-            );
+        for (size_t i = 0; i < threads; ++i) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back([this, i] { workerLoop(static_cast<int>(i)); });
         }
     }
 
     // Add new work item to the pool
     template<class F, class... Args>
     auto enqueue(F&& f, Args&&... args)
-        -> std::future<typename std::result_of<F(Args...)>::type>
+        -> std::future<std::invoke_result_t<F, Args...>>
     {
-        using return_type = typename std::result_of<F(Args...)>::type;
+        using return_type = std::invoke_result_t<F, Args...>;
 
         auto task = std::make_shared< std::packaged_task<return_type()> >(
             std::bind(std::forward<F>(f), std::forward<Args>(args)...)
         );
-        
+
         std::future<return_type> res = task->get_future();
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex);
-            if(stop)
-                throw std::runtime_error("enqueue on stopped ThreadPool");
-            tasks.emplace([task](){ (*task)(); });
-        }
-        condition.notify_one();
+        if (stop.load())
+            throw std::runtime_error("enqueue on stopped ThreadPool");
+        submit([task]() { (*task)(); });
         return res;
     }
 
-    // Destructor joins all threads
+    // Queues a task. From a worker of this pool it goes on that worker's own deque,
+    // and is run right away by the caller if the deque is full.
+    void submit(Task task) {
+        // Counted before it is visible so `pending` never drops below the number of queued tasks
+        pending.fetch_add(1);
+        int self = currentWorker();
+        if (self >= 0) {
+            if (!queues[self]->push(task)) {
+                pending.fetch_sub(1);
+                task();
+                return;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(injector_mutex);
+            injector.push_back(std::move(task));
+        }
+        if (sleepers.load() > 0) {
+            { std::lock_guard<std::mutex> lock(sleep_mutex); }
+            wake.notify_one();
+        }
+    }
+
+    // Runs one queued task on the calling thread, if any can be found
+    bool runPendingTask() {
+        Task task;
+        if (!findTask(currentWorker(), task)) return false;
+        task();
+        return true;
+    }
+
+    // Number of worker threads
+    size_t size() const { return workers.size(); }
+
+    // Destructor joins all threads once every queued task has run
     ~ThreadPool() {
         {
-            std::unique_lock<std::mutex> lock(queue_mutex);
+            std::lock_guard<std::mutex> lock(sleep_mutex);
             stop = true;
         }
-        condition.notify_all();
+        wake.notify_all();
         for(std::thread &worker: workers)
             worker.join();
     }
 
 private:
-    std::vector< std::thread > workers;
-    std::queue< std::function<void()> > tasks;
-    std::mutex queue_mutex;
-    std::condition_variable condition;
-    bool stop;
+    // Bounded ring buffer; the owner works at the back, thieves take from the front
+    struct alignas(64) WorkerQueue {
+        static constexpr size_t CAPACITY = 256;
+        std::mutex mutex;
+        std::array<Task, CAPACITY> ring;
+        size_t head = 0;
+        size_t tail = 0;
+
+        bool push(Task& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tail - head == CAPACITY) return false;
+            ring[tail++ % CAPACITY] = std::move(task);
+            return true;
+        }
+        bool popBack(Task& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tail == head) return false;
+            task = std::move(ring[--tail % CAPACITY]);
+            return true;
+        }
+        bool stealFront(Task& task) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (tail == head) return false;
+            task = std::move(ring[head++ % CAPACITY]);
+            return true;
+        }
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::mutex injector_mutex;
+    std::deque<Task> injector; // Tasks submitted from threads outside the pool
+    std::vector<std::thread> workers;
+
+    std::atomic<int> pending{0};  // Queued tasks not yet taken
+    std::atomic<int> sleepers{0}; // Workers blocked on `wake`
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<bool> stop{false};
+
+    struct WorkerIdentity {
+        const ThreadPool* pool = nullptr;
+        int index = -1;
+    };
+    static WorkerIdentity& identity() {
+        thread_local WorkerIdentity id;
+        return id;
+    }
+    int currentWorker() const {
+        const WorkerIdentity& id = identity();
+        return id.pool == this ? id.index : -1;
+    }
+
+    // Sleeps until `group` has no tasks left or new work is queued
+    void sleepUntilJoined(TaskGroup& group) {
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        group.sleeping = true;
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this, &group] { return group.pending.load() == 0 || pending.load() > 0; });
+        sleepers.fetch_sub(1);
+        group.sleeping = false;
+    }
+
+    // Counts down a group's task under sleep_mutex, so its owner cannot be between checking
+    // `pending` and going to sleep, and wakes the owner if it is asleep
+    void finishLastTask(TaskGroup& group) {
+        bool owner_asleep;
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            owner_asleep = group.sleeping;
+            group.pending.fetch_sub(1, std::memory_order_release);
+        }
+        if (owner_asleep) wake.notify_all();
+    }
+
+    bool findTask(int self, Task& task) {
+        bool found = self >= 0 && queues[self]->popBack(task);
+        if (!found) {
+            std::lock_guard<std::mutex> lock(injector_mutex);
+            if (!injector.empty()) {
+                task = std::move(injector.front());
+                injector.pop_front();
+                found = true;
+            }
+        }
+        for (size_t i = 1; !found && i <= queues.size(); ++i) {
+            size_t victim = (static_cast<size_t>(self + 1) + i) % queues.size();
+            found = static_cast<int>(victim) != self && queues[victim]->stealFront(task);
+        }
+        if (found) pending.fetch_sub(1);
+        return found;
+    }
+
+    void workerLoop(int index) {
+        identity() = {this, index};
+        for (;;) {
+            if (runPendingTask()) continue;
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            if (stop && pending.load() == 0) return;
+            sleepers.fetch_add(1);
+            wake.wait(lock, [this] { return stop || pending.load() > 0; });
+            sleepers.fetch_sub(1);
+        }
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,104 @@
+#ifndef TIME_MANAGER_HPP
+#define TIME_MANAGER_HPP
+
+#include <chrono>
+#include <iosfwd>
+
+/**
+ * @struct MoveBudget
+ * @brief Time one search may take: it aims to be done by `optimum` and must stop by `maximum`.
+ * A plain duration converts to a budget with both set to it.
+ */
+struct MoveBudget {
+    std::chrono::duration<double> optimum;
+    std::chrono::duration<double> maximum;
+
+    MoveBudget(std::chrono::duration<double> optimum, std::chrono::duration<double> maximum)
+        : optimum(optimum), maximum(maximum) {}
+    template<class Rep, class Period>
+    MoveBudget(std::chrono::duration<Rep, Period> limit) : optimum(limit), maximum(limit) {}
+};
+
+/**
+ * @struct TimeControl
+ * @brief The clock a game is played under: a fixed time per move, or a game clock per side.
+ */
+struct TimeControl {
+    std::chrono::duration<double> move_time{10};      // Per move, used when there is no game clock
+    std::chrono::duration<double> game_time{0};       // Whole-game clock per side; zero for none
+    std::chrono::duration<double> increment{0};       // Added to the game clock after every move
+    std::chrono::duration<double> move_overhead{0.5}; // Kept back every move for network and bookkeeping
+    int moves_to_go = 30;                             // Moves the remaining game clock is spread over
+};
+
+// Describes the time control in a log line, e.g. "60s + 0.5s per move"
+std::ostream& operator<<(std::ostream& out, const TimeControl& control);
+
+/**
+ * @class TimeManager
+ * @brief Tracks our side's clock over a game and gives each move its budget.
+ *
+ * With a fixed time per move, both limits are that time less the overhead: time left over
+ * is lost anyway. With a game clock, the optimum is an even share of what is left over the
+ * next `moves_to_go` moves, and the maximum allows a few times that for unstable positions.
+ */
+class TimeManager {
+public:
+    explicit TimeManager(const TimeControl& control = {});
+
+    MoveBudget nextMove() const;
+    // Charges a move that took `used` to the game clock
+    void moveMade(std::chrono::duration<double> used);
+
+    std::chrono::duration<double> remaining() const { return clock; }
+    const TimeControl& control() const { return time_control; }
+
+private:
+    static constexpr double MAX_OVER_OPTIMUM = 4.0; // A move may take this many even shares...
+    static constexpr double MAX_CLOCK_SHARE = 0.3;  // ...but never more than this part of the clock
+    static constexpr double INCREMENT_SHARE = 0.75; // Part of the increment spent on the move that earns it
+
+    TimeControl time_control;
+    std::chrono::duration<double> clock; // Our side's remaining game time
+};
+
+/**
+ * @class SearchTimer
+ * @brief Decides when iterative deepening should stop starting new iterations.
+ *
+ * The next iteration is predicted to cost the last one times the effective branching
+ * factor, the growth from the iteration before it, and is only started if it would end by
+ * the target. The target starts at the budget's optimum and is stretched towards the
+ * maximum while the best move keeps changing from one iteration to the next. A search still
+ * running at the maximum is aborted, and the caller discards that iteration. The first
+ * iteration is always started and run to completion, so even a budget that has already run
+ * out yields a searched move.
+ */
+class SearchTimer {
+public:
+    SearchTimer(const MoveBudget& budget, std::chrono::steady_clock::time_point start);
+
+    // Records a completed iteration and the best move it found
+    void iterationCompleted(int best_move);
+    bool shouldStartIteration() const;
+
+    std::chrono::duration<double> elapsed() const { return std::chrono::steady_clock::now() - start; }
+    // Expected duration of the next iteration; zero until one has completed
+    std::chrono::duration<double> predictedIteration() const;
+
+private:
+    static constexpr double DEFAULT_BRANCHING = 3.0; // Growth assumed before two iterations are timed
+    static constexpr double MAX_BRANCHING = 10.0;
+    static constexpr double INSTABILITY_DECAY = 0.5; // Per iteration
+    static constexpr double INSTABILITY_WEIGHT = 1.0; // Target grows by this part of the optimum per unit
+
+    MoveBudget budget;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point last_completed;
+    std::chrono::duration<double> last_iteration{0};
+    std::chrono::duration<double> previous_iteration{0};
+    int best_move = -1;
+    double instability = 0.0; // Recent best-move changes, older ones decayed
+};
+
+#endif // TIME_MANAGER_HPP
@@ -0,0 +1,103 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @enum Bound
+ * @brief How a stored score relates to the true minimax value of the position.
+ */
+enum class Bound : std::uint8_t {
+    None,
+    Exact, // Score is the exact value
+    Lower, // Search failed high: true value >= score
+    Upper  // Search failed low:  true value <= score
+};
+
+/**
+ * @struct TTEntry
+ * @brief Decoded contents of one transposition table slot.
+ */
+struct TTEntry {
+    std::uint64_t key;
+    std::int32_t score;
+    std::int8_t depth;
+    Bound bound;
+    std::int8_t move;       // Best piece id found, -1 if none
+    std::uint8_t generation; // Search that last wrote this slot, used for aging
+};
+
+/**
+ * @class TranspositionTable
+ * @brief Fixed-size hash table of search results keyed by Board::getHash(), shared by
+ * all search threads without locks.
+ *
+ * Each slot is two atomic words: the entry packed into 64 bits, and the key XORed with
+ * that data word. A slot torn by two threads writing at once no longer XORs back to its
+ * key, so it simply reads as a miss. Slots are grouped four to a 64-byte cluster so a
+ * probe touches a single cache line. When a cluster is full, the entry with the lowest
+ * depth (older searches count as shallower) is replaced.
+ *
+ * resize() and clear() must not run concurrently with a search. newSearch() may, so that
+ * searches of unrelated games can share one table. The generation is 8 bits, so such a
+ * table should be aged once per round of moves over all games, not once per search.
+ */
+class TranspositionTable {
+public:
+    struct Stats {
+        std::uint64_t probes = 0;
+        std::uint64_t hits = 0;
+        std::uint64_t stores = 0;
+        std::uint64_t replacements = 0; // Stores that evicted a different position
+    };
+
+    explicit TranspositionTable(std::size_t size_mb = 16);
+
+    void resize(std::size_t size_mb);
+    void clear();
+    void newSearch(); // Ages all existing entries; safe while other threads search
+
+    // Fills `entry` and returns true if the position is stored.
+    bool probe(std::uint64_t key, TTEntry& entry);
+    void store(std::uint64_t key, int depth, Bound bound, int score, int move);
+
+    Stats getStats() const;
+    void resetStats();
+    double hitRate() const;
+
+private:
+    static constexpr int CLUSTER_SIZE = 4;
+    struct Slot {
+        std::atomic<std::uint64_t> key_xor_data{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+    struct alignas(64) Cluster {
+        Slot slots[CLUSTER_SIZE];
+    };
+
+    // Statistics are striped over cache lines so threads do not contend on one counter
+    static constexpr int STAT_STRIPES = 64;
+    struct alignas(64) StatStripe {
+        std::atomic<std::uint64_t> probes{0};
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> stores{0};
+        std::atomic<std::uint64_t> replacements{0};
+    };
+
+    std::unique_ptr<Cluster[]> clusters;
+    std::uint64_t index_mask = 0;
+    std::atomic<std::uint8_t> generation{0};
+    std::unique_ptr<StatStripe[]> stats;
+
+    Cluster& clusterFor(std::uint64_t key) { return clusters[key & index_mask]; }
+    static StatStripe& localStripe(StatStripe* stripes);
+
+    static std::uint64_t pack(int depth, Bound bound, int score, int move, std::uint8_t generation);
+    static TTEntry unpack(std::uint64_t key, std::uint64_t data);
+    static TTEntry read(const Slot& slot);
+};
+
+#endif // TRANSPOSITION_TABLE_HPP
@@ -1,52 +1,115 @@
 #include "Board.hpp"
-#include <iostream>
+#include <bit>
 #include <stdexcept>
-#include <algorithm>
 #include <vector>
-#include <map>
 
-Board::Board() : currentPlayer(0) {
-    // Player 0 (Horizontal, IDs 0-4)
-    for (int i = 0; i < 5; ++i) {
-        pieces.push_back({i, 0, false, 0});
-    }
-    // Player 1 (Vertical, IDs 5-9)
-    for (int i = 0; i < 5; ++i) {
-        pieces.push_back({i + 5, 0, false, 1});
+namespace {
+
+constexpr std::uint64_t splitMix64(std::uint64_t& seed) {
+    std::uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+struct ZobristKeys {
+    std::uint64_t piece[Board::NUM_PIECES][Board::PROGRESS_RETURNED + 1];
+    std::uint64_t side; // XORed in when player 1 is to move
+};
+
+constexpr ZobristKeys buildZobristKeys() {
+    ZobristKeys keys{};
+    std::uint64_t seed = 0x5371AD20C0FFEEULL;
+    for (auto& piece : keys.piece) {
+        for (auto& key : piece) key = splitMix64(seed);
     }
+    keys.side = splitMix64(seed);
+    return keys;
 }
 
-std::unique_ptr<Board> Board::clone() const {
-    auto newBoard = std::make_unique<Board>();
-    newBoard->pieces = this->pieces;
-    newBoard->currentPlayer = this->currentPlayer;
-    return newBoard;
+constexpr ZobristKeys zobrist = buildZobristKeys();
+
+constexpr std::array<int, Board::PROGRESS_RETURNED + 1> buildProgressScores() {
+    std::array<int, Board::PROGRESS_RETURNED + 1> scores{};
+    for (int progress = 0; progress <= Board::PROGRESS_RETURNED; ++progress) {
+        scores[progress] = Board::progressScore(progress);
+    }
+    return scores;
 }
 
-bool Board::isGameOver() const {
-    return getWinner() != -1;
+constexpr auto progress_scores = buildProgressScores();
+
+} // namespace
+
+Board::Board() : progress_bits(0), hash_key(0), currentPlayer(0), score(0), returned{0, 0} {
+    // Player 0 (Horizontal, IDs 0-4) and Player 1 (Vertical, IDs 5-9) all start at progress 0
+    hash_key = computeHash();
 }
 
-int Board::getWinner() const {
-    int returned_h = 0;
-    int returned_v = 0;
-    for (const auto& piece : pieces) {
-        if (piece.player == 0 && piece.position == 0 && piece.has_turned_around) {
-            returned_h++;
-        } else if (piece.player == 1 && piece.position == 0 && piece.has_turned_around) {
-            returned_v++;
+Board Board::fromProgress(const std::array<int, 10>& progress, int player) {
+    Board board;
+    for (int id = 0; id < NUM_PIECES; ++id) {
+        if (progress[id] < 0 || progress[id] > PROGRESS_RETURNED) {
+            throw std::out_of_range("Invalid progress value in fromProgress");
         }
+        board.setProgress(id, progress[id]);
+    }
+    if (player != board.currentPlayer) board.switchPlayer();
+    return board;
+}
+
+std::uint64_t Board::computeHash() const {
+    std::uint64_t key = 0;
+    for (int id = 0; id < NUM_PIECES; ++id) {
+        key ^= zobrist.piece[id][getProgress(id)];
+    }
+    if (currentPlayer == 1) key ^= zobrist.side;
+    return key;
+}
+
+void Board::verifyIncrementalState() const {
+    if (hash_key != computeHash()) {
+        throw std::logic_error("Zobrist key out of sync with board state.");
+    }
+    int expected_score = 0;
+    int expected_returned[2] = {0, 0};
+    for (int id = 0; id < NUM_PIECES; ++id) {
+        int progress = getProgress(id);
+        expected_score += id < 5 ? progressScore(progress) : -progressScore(progress);
+        if (progress == PROGRESS_RETURNED) ++expected_returned[id / 5];
+    }
+    if (score != expected_score || returned[0] != expected_returned[0] || returned[1] != expected_returned[1]) {
+        throw std::logic_error("Incremental evaluation out of sync with board state.");
     }
-    if (returned_h >= 4) return 0;
-    if (returned_v >= 4) return 1;
-    return -1;
+}
+
+void Board::setProgress(int pieceId, int progress) {
+    int old_progress = getProgress(pieceId);
+    hash_key ^= zobrist.piece[pieceId][old_progress] ^ zobrist.piece[pieceId][progress];
+
+    int delta = progress_scores[progress] - progress_scores[old_progress];
+    score = static_cast<std::int16_t>(pieceId < 5 ? score + delta : score - delta);
+    returned[pieceId / 5] = static_cast<std::uint8_t>(returned[pieceId / 5]
+        + (progress == PROGRESS_RETURNED) - (old_progress == PROGRESS_RETURNED));
+
+    progress_bits &= ~(std::uint64_t{0xF} << (4 * pieceId));
+    progress_bits |= static_cast<std::uint64_t>(progress) << (4 * pieceId);
 }
 
 int Board::getCurrentPlayer() const {
     return currentPlayer;
 }
 
-const std::vector<Piece>& Board::getPieces() const {
+Piece Board::getPiece(int pieceId) const {
+    int progress = getProgress(pieceId);
+    return {pieceId, positionOf(progress), turnedOf(progress), pieceId / 5};
+}
+
+std::array<Piece, 10> Board::getPieces() const {
+    std::array<Piece, 10> pieces;
+    for (int id = 0; id < NUM_PIECES; ++id) {
+        pieces[id] = getPiece(id);
+    }
     return pieces;
 }
 
@@ -54,129 +117,160 @@ std::vector<int> Board::getLegalMoves() const {
     std::vector<int> legal_moves;
     int start_id = (currentPlayer == 0) ? 0 : 5;
     for (int i = 0; i < 5; ++i) {
-        const auto& piece = pieces[start_id + i];
-        if (!(piece.position == 0 && piece.has_turned_around)) {
-            legal_moves.push_back(piece.id);
+        if (getProgress(start_id + i) != PROGRESS_RETURNED) {
+            legal_moves.push_back(start_id + i);
         }
     }
     return legal_moves;
 }
 
-void Board::makeMove(int pieceId) {
-    if (pieceId < 0 || pieceId >= 10) {
-        throw std::out_of_range("Invalid piece ID in makeMove");
-    }
-
-    Piece& moving_piece = pieces[pieceId];
-    if (moving_piece.player != currentPlayer) {
-         throw std::logic_error("Attempted to move opponent's piece.");
+int Board::getLegalMoveMask() const {
+    int start_id = (currentPlayer == 0) ? 0 : 5;
+    int mask = 0;
+    for (int i = 0; i < 5; ++i) {
+        if (getProgress(start_id + i) != PROGRESS_RETURNED) {
+            mask |= 1 << i;
+        }
     }
+    return mask;
+}
 
-    int speed = getPieceSpeed(moving_piece);
-    int direction = moving_piece.has_turned_around ? -1 : 1;
-    int current_pos = moving_piece.position;
-    bool jump_occurred_on_move = false;
-
-    // --- FINAL, DEFINITIVE REWRITE OF JUMP LOGIC ---
+namespace {
 
-    // 1. Simulate the initial move step by step
-    for (int i = 0; i < speed; ++i) {
-        int next_pos = current_pos + direction;
+constexpr int speeds_h[5] = {1, 3, 2, 3, 1};
+constexpr int speeds_v[5] = {3, 1, 2, 1, 3};
 
-        // Check for an opponent at the next step's intersection
-        Piece* opponent_to_jump = nullptr;
-        for (auto& opponent : pieces) {
-            if (opponent.player == moving_piece.player) continue;
+constexpr int pieceSpeed(int pieceId, int progress) {
+    int base_speed = (pieceId < 5) ? speeds_h[pieceId % 5] : speeds_v[pieceId % 5];
+    if (Board::turnedOf(progress)) {
+        if (base_speed == 1) return 3;
+        if (base_speed == 3) return 1;
+    }
+    return base_speed;
+}
 
-            int moving_track = (moving_piece.id % 5) + 1;
-            int opponent_track = (opponent.id % 5) + 1;
-            int opponent_pos = opponent.position;
+// Replays the step-by-step jump rules for one piece against a given crossing-lane occupancy.
+constexpr Board::MoveTransition simulateMove(int pieceId, int progress, int occupancy) {
+    bool turned = Board::turnedOf(progress);
+    int direction = turned ? -1 : 1;
+    int current_pos = Board::positionOf(progress);
+    int resets = 0;
 
-            if (moving_piece.player == 0 && opponent_pos == moving_track && opponent_track == next_pos) {
-                opponent_to_jump = &opponent;
-                break;
-            } else if (moving_piece.player == 1 && opponent_pos == moving_track && opponent_track == next_pos) {
-                opponent_to_jump = &opponent;
-                break;
-            }
-        }
+    // An opponent on track p sits on our lane at crossing position p when bit p-1 is set.
+    auto occupied = [occupancy](int pos) {
+        return pos >= 1 && pos <= 5 && (occupancy & (1 << (pos - 1))) != 0;
+    };
 
-        if (opponent_to_jump) {
-            // First jump happens, move ends here.
-            opponent_to_jump->position = opponent_to_jump->has_turned_around ? 6 : 0;
-            current_pos = next_pos;
-            jump_occurred_on_move = true;
-            break; // Stop the initial move
-        } else {
-            // No jump, just move one step.
-            current_pos = next_pos;
+    // 1. Walk the initial move step by step; the first jump ends it and we land one space after.
+    for (int i = 0; i < pieceSpeed(pieceId, progress); ++i) {
+        current_pos += direction;
+        if (occupied(current_pos)) {
+            resets |= 1 << (current_pos - 1);
+            current_pos += direction;
+            break;
         }
     }
 
-    // 2. If a jump occurred on the initial move, land one space after.
-    if (jump_occurred_on_move) {
+    // 2. Chain reactions from the landing spot
+    while (resets != 0 && occupied(current_pos)) {
+        resets |= 1 << (current_pos - 1);
         current_pos += direction;
     }
-    
-    // 3. Handle chain reactions from the landing spot
-    while (true) {
-        Piece* opponent_in_landing_spot = nullptr;
-        for (auto& opponent : pieces) {
-            if (opponent.player == moving_piece.player) continue;
-
-            int moving_track = (moving_piece.id % 5) + 1;
-            int opponent_track = (opponent.id % 5) + 1;
-            int opponent_pos = opponent.position;
-
-            if (moving_piece.player == 0 && opponent_pos == moving_track && opponent_track == current_pos) {
-                opponent_in_landing_spot = &opponent;
-                break;
-            } else if (moving_piece.player == 1 && opponent_pos == moving_track && opponent_track == current_pos) {
-                opponent_in_landing_spot = &opponent;
-                break;
+
+    // 3. Clamp position and handle turnarounds
+    int destination;
+    if (!turned) {
+        destination = current_pos >= 6 ? Board::PROGRESS_TURNED : current_pos;
+    } else {
+        destination = current_pos <= 0 ? Board::PROGRESS_RETURNED : Board::PROGRESS_RETURNED - current_pos;
+    }
+    return {static_cast<std::uint8_t>(destination), static_cast<std::uint8_t>(resets)};
+}
+
+using MoveTable = std::array<std::array<std::array<Board::MoveTransition, 32>,
+                                        Board::PROGRESS_RETURNED + 1>, Board::NUM_PIECES>;
+
+constexpr MoveTable buildMoveTable() {
+    MoveTable table{};
+    for (int id = 0; id < Board::NUM_PIECES; ++id) {
+        for (int progress = 0; progress <= Board::PROGRESS_RETURNED; ++progress) {
+            for (int occupancy = 0; occupancy < 32; ++occupancy) {
+                table[id][progress][occupancy] = simulateMove(id, progress, occupancy);
             }
         }
+    }
+    return table;
+}
 
-        if (opponent_in_landing_spot) {
-            // Chain jump! Reset this opponent and move one step further.
-            opponent_in_landing_spot->position = opponent_in_landing_spot->has_turned_around ? 6 : 0;
-            current_pos += direction;
-        } else {
-            // No opponent in the landing spot, the chain is over.
-            break;
+constexpr MoveTable move_table = buildMoveTable();
+
+} // namespace
+
+// Bit k is set when the opponent on track k+1 sits where it crosses the mover's track.
+int Board::crossingOccupancy(int pieceId) const {
+    int moving_track = (pieceId % 5) + 1;
+    int opponent_base = pieceId < 5 ? 5 : 0;
+    int occupancy = 0;
+    for (int k = 0; k < 5; ++k) {
+        if (positionOf(getProgress(opponent_base + k)) == moving_track) {
+            occupancy |= 1 << k;
         }
     }
+    return occupancy;
+}
+
+Board::MoveTransition Board::lookupMoveTransition(int pieceId, int progress, int occupancy) {
+    return move_table[pieceId][progress][occupancy];
+}
+
+Board::MoveTransition Board::getMoveTransition(int pieceId) const {
+    return lookupMoveTransition(pieceId, getProgress(pieceId), crossingOccupancy(pieceId));
+}
+
+Board::MoveUndo Board::makeMove(int pieceId) {
+    if (pieceId < 0 || pieceId >= NUM_PIECES) {
+        throw std::out_of_range("Invalid piece ID in makeMove");
+    }
+    if (pieceId / 5 != currentPlayer) {
+         throw std::logic_error("Attempted to move opponent's piece.");
+    }
 
-    moving_piece.position = current_pos;
-    
-    // --- END FINAL REWRITE ---
+    int from_progress = getProgress(pieceId);
+    MoveTransition transition = getMoveTransition(pieceId);
+    setProgress(pieceId, transition.destination);
 
-    // Clamp position and handle turnarounds
-    if (!moving_piece.has_turned_around && moving_piece.position >= 6) {
-        moving_piece.position = 6;
-        moving_piece.has_turned_around = true;
-    } else if (moving_piece.has_turned_around && moving_piece.position <= 0) {
-        moving_piece.position = 0;
+    // Jumped opponents go back to the start of their current leg
+    int opponent_base = pieceId < 5 ? 5 : 0;
+    for (int resets = transition.resets; resets != 0; resets &= resets - 1) {
+        int opponent = opponent_base + std::countr_zero(static_cast<unsigned>(resets));
+        setProgress(opponent, turnedOf(getProgress(opponent)) ? PROGRESS_TURNED : 0);
     }
-    
+
     switchPlayer();
+#ifdef SQUADRO_VERIFY_HASH
+    verifyIncrementalState();
+#endif
+    return {static_cast<std::uint8_t>(pieceId), static_cast<std::uint8_t>(from_progress), transition.resets};
 }
 
-int Board::getPieceSpeed(const Piece& piece) const {
-    int base_speed;
-    if (piece.player == 0) {
-        base_speed = speeds_h[piece.id % 5];
-    } else {
-        base_speed = speeds_v[piece.id % 5];
-    }
+void Board::unmakeMove(const MoveUndo& undo) {
+    switchPlayer();
 
-    if (piece.has_turned_around) {
-        if (base_speed == 1) return 3;
-        if (base_speed == 3) return 1;
+    // Put every jumped opponent back on the mover's lane, on the leg it was sent back along
+    int moving_track = (undo.pieceId % 5) + 1;
+    int opponent_base = undo.pieceId < 5 ? 5 : 0;
+    for (int resets = undo.resets; resets != 0; resets &= resets - 1) {
+        int opponent = opponent_base + std::countr_zero(static_cast<unsigned>(resets));
+        setProgress(opponent, turnedOf(getProgress(opponent)) ? PROGRESS_RETURNED - moving_track : moving_track);
     }
-    return base_speed;
+
+    setProgress(undo.pieceId, undo.fromProgress);
+#ifdef SQUADRO_VERIFY_HASH
+    verifyIncrementalState();
+#endif
 }
 
 void Board::switchPlayer() {
     currentPlayer = 1 - currentPlayer;
+    hash_key ^= zobrist.side;
 }
@@ -1,31 +1,65 @@
 #include "GameController.hpp"
+#include "EngineData.hpp"
+#include "MctsAI.hpp"
+#include "MinimaxAI.hpp"
 #include <iostream>
 #include <stdexcept>
 #include "httplib.h"
 #include "json.hpp"
 using json = nlohmann::json;
 
-GameController::GameController(const std::string& host, int send_port, int receive_port, int ai_player_id)
-    : host_ip(host), 
+namespace {
+
+std::unique_ptr<SearchEngine> createEngine(GameController::EngineType engine) {
+    if (engine == GameController::EngineType::Mcts) return std::make_unique<MctsAI>();
+
+    auto minimax = std::make_unique<MinimaxAI>();
+    minimax->setTablebase(loadOptional<Tablebase>(TABLEBASE_PATH, "endgame tablebase"));
+    minimax->setOpeningBook(loadOptional<OpeningBook>(OPENING_BOOK_PATH, "opening book"));
+    return minimax;
+}
+
+} // namespace
+
+GameController::GameController(const std::string& host, int send_port, int receive_port, int ai_player_id,
+                               EngineType engine, const TimeControl& time_control,
+                               const HttpClientOptions& http)
+    : ai(createEngine(engine)),
+      host_ip(host), 
       port_to_send(send_port), 
       port_to_receive(receive_port), 
       ai_player(ai_player_id), // This will be 1 or 2
+      time_manager(time_control),
       ai_moved_this_turn(false), // initialize the flag
+      sender(host, send_port, http),
       svr(std::make_unique<httplib::Server>())
 {
-    std::cout << "AI Bot initializing for Player " << ai_player << "...\n";
-    std::cout << "Move time limit: " << move_time_limit.count() << " seconds.\n";
+    std::cout << "AI Bot initializing for Player " << ai_player << " with the "
+              << (engine == EngineType::Mcts ? "MCTS" : "minimax") << " engine...\n";
+    std::cout << "Time control: " << time_control << ".\n";
 }
 
 // Destructor
 GameController::~GameController() {
-    if (svr->is_running()) svr->stop();
+    stop();
     if (server_thread.joinable()) server_thread.join();
 }
 
+void GameController::stop() {
+    {
+        std::lock_guard<std::mutex> lock(board_mutex);
+        stopped = true;
+    }
+    board_changed.notify_one();
+    ai->stop();
+    if (svr->is_running()) svr->stop();
+}
+
 // Sets up and runs the HTTP server in a separate thread
 void GameController::startListeningServer() {
     svr->Post("/", [this](const httplib::Request& req, httplib::Response& res) {
+        // The opponent has moved, so our own search is about to start and needs the cores
+        ai->stopPondering();
         std::lock_guard<std::mutex> lock(board_mutex);
 
         int current_internal_player = board.getCurrentPlayer();
@@ -48,6 +82,7 @@ void GameController::startListeningServer() {
 
             board.makeMove(internal_piece_id);            
             ai_moved_this_turn = false; // reset flag for next turn
+            board_changed.notify_one();
             res.set_content("{\"status\": true}", "application/json");
 
         } catch (const std::exception& e) {
@@ -70,43 +105,52 @@ void GameController::run() {
     startListeningServer();
 
     while (true) {
-        bool is_my_turn = false;
         {
-            std::lock_guard<std::mutex> lock(board_mutex);
-            if (board.isGameOver()) break;
-            is_my_turn = ((board.getCurrentPlayer() + 1) == this->ai_player);
-        }
-
-        if (is_my_turn && !ai_moved_this_turn) {
-            makeAndSendAIMove();
+            // Sleep until the game is over or it is our turn to move; the move handler wakes us
+            std::unique_lock<std::mutex> lock(board_mutex);
+            board_changed.wait(lock, [this] {
+                bool is_my_turn = (board.getCurrentPlayer() + 1) == this->ai_player;
+                return stopped || board.isGameOver() || (is_my_turn && !ai_moved_this_turn);
+            });
+            if (stopped || board.isGameOver()) break;
             ai_moved_this_turn = true;
-        } else if (!is_my_turn) {
-            std::lock_guard<std::mutex> lock(board_mutex);
-            ai_moved_this_turn = false;
         }
-
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        makeAndSendAIMove();
     }
 
-    std::cout << "Game Over! Winner is Player " << board.getWinner() + 1 << std::endl;
+    ai->stopPondering();
+    std::lock_guard<std::mutex> lock(board_mutex);
+    if (board.isGameOver()) {
+        std::cout << "Game Over! Winner is Player " << board.getWinner() + 1 << std::endl;
+    } else {
+        std::cout << "Game stopped before it was over." << std::endl;
+    }
 }
 
 // AI makes move and sends to GUI
 void GameController::makeAndSendAIMove() {
-    std::unique_ptr<Board> board_copy_ptr;
+    Board board_copy;
     {
         std::lock_guard<std::mutex> lock(board_mutex);
         if ((board.getCurrentPlayer() + 1) != ai_player) return;
-        board_copy_ptr = board.clone();
+        board_copy = board;
     }
 
-    std::cout << "AI is thinking...\n";
-    int best_move_id = ai.findBestMove(*board_copy_ptr, move_time_limit);
+    auto turn_start = std::chrono::steady_clock::now();
+    MoveBudget budget = time_manager.nextMove();
+    std::cout << "AI is thinking for " << budget.optimum.count() << "s (at most "
+              << budget.maximum.count() << "s)...\n";
+    int best_move_id = ai->findBestMove(board_copy, budget);
 
     if (best_move_id == -1) {
         std::cerr << "AI could not find a legal move.\n";
         return;
     }
+    {
+        // A search cut short by stop() is not played
+        std::lock_guard<std::mutex> lock(board_mutex);
+        if (stopped) return;
+    }
 
     int gui_move_to_send = (best_move_id % 5) + 1;
     std::cout << "AI chose pawn " << gui_move_to_send << " sent to GUI." << std::endl;
@@ -115,18 +159,11 @@ void GameController::makeAndSendAIMove() {
     move_to_send_json["move"] = gui_move_to_send;
     std::string json_string = move_to_send_json.dump();
 
-    httplib::Client cli(host_ip, port_to_send);
-    cli.set_connection_timeout(5);
-
-    auto res = cli.Post("/", json_string, "application/json");
-
-    if (res && res->status == 200) {
+    if (sender.send("/", json_string)) {
+        time_manager.moveMade(std::chrono::steady_clock::now() - turn_start);
         std::cout << "Server accepted move. Updating local board state.\n";
         std::lock_guard<std::mutex> lock(board_mutex);
         board.makeMove(best_move_id);
-    } else {
-        std::cerr << "Server rejected move." << std::endl;
-        if(res) std::cerr << "Status code: " << res->status << std::endl;
-        else std::cerr << "Error: " << httplib::to_string(res.error()) << std::endl;
+        if (!board.isGameOver()) ai->startPondering(board);
     }
 }
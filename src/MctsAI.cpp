@@ -0,0 +1,175 @@
+#include "MctsAI.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <future>
+#include <iostream>
+
+void MctsAI::Node::reset(int piece_id) {
+    visits.store(0, std::memory_order_relaxed);
+    wins.store(0, std::memory_order_relaxed);
+    first_child = 0;
+    move = static_cast<std::int8_t>(piece_id);
+    num_children = 0;
+    state.store(Leaf, std::memory_order_relaxed);
+}
+
+MctsAI::MctsAI(std::size_t num_threads, std::size_t tree_size_mb, std::size_t max_playouts, double exploration)
+    : pool(num_threads),
+      capacity(std::max<std::size_t>(tree_size_mb * 1024 * 1024 / sizeof(Node), 1 + Board::NUM_PIECES / 2)),
+      max_playouts(max_playouts),
+      exploration(exploration)
+{
+    nodes = std::make_unique<Node[]>(capacity);
+}
+
+int MctsAI::findBestMove(const Board& board, const MoveBudget& budget) {
+    auto start_time = std::chrono::steady_clock::now();
+    StopRequests::Scope stop_scope(stop_requests);
+
+    int mask = board.getLegalMoveMask();
+    if (mask == 0) return -1;
+    int first_id = board.getCurrentPlayer() * 5;
+    if (std::popcount(static_cast<unsigned>(mask)) == 1) return first_id + std::countr_zero(static_cast<unsigned>(mask));
+
+    // The tree is rebuilt for every move; node 0 is the root and is expanded before the workers start
+    nodes[0].reset(-1);
+    node_count.store(1, std::memory_order_relaxed);
+    expand(nodes[0], board);
+
+    std::atomic<std::size_t> claimed{0}; // Playouts started so far, across all workers
+    stop_search.store(false, std::memory_order_relaxed);
+    // Playouts have no iterations to predict, so the search simply runs to the optimum
+    const std::chrono::duration<double> time_limit = budget.optimum;
+
+    std::vector<std::future<void>> workers;
+    for (std::size_t t = 0; t < pool.size(); ++t) {
+        workers.emplace_back(pool.enqueue([this, &board, &claimed, start_time, time_limit]() {
+            Worker worker;
+            for (std::size_t done = 0; !stopRequested(); ++done) {
+                // A playout is short, so the clock is only read every 64 of them, and not before
+                // the first: a budget that is already spent still gets some playouts
+                if (done % 64 == 63 && std::chrono::steady_clock::now() - start_time > time_limit) {
+                    stop_search.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                if (max_playouts != 0 && claimed.fetch_add(1, std::memory_order_relaxed) >= max_playouts) break;
+                runIteration(board, worker);
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+
+    // The most visited move is the most trusted one
+    const Node& root = nodes[0];
+    const Node* best = &nodes[root.first_child];
+    for (std::uint32_t i = 1; i < root.num_children; ++i) {
+        const Node& child = nodes[root.first_child + i];
+        if (child.visits.load(std::memory_order_relaxed) > best->visits.load(std::memory_order_relaxed)) best = &child;
+    }
+
+    std::uint32_t best_visits = best->visits.load(std::memory_order_relaxed);
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now() - start_time);
+    std::cout << "MCTS: " << root.visits.load(std::memory_order_relaxed) << " playouts on " << pool.size()
+              << " threads in " << elapsed.count() << "s, " << node_count.load(std::memory_order_relaxed) << " nodes. "
+              << "Best move is: " << static_cast<int>(best->move) << " with " << best_visits << " visits ("
+              << (best_visits ? 100.0 * best->wins.load(std::memory_order_relaxed) / best_visits : 0.0) << "% won).\n";
+
+    return best->move;
+}
+
+void MctsAI::stop() {
+    stop_requests.request();
+}
+
+bool MctsAI::stopRequested() const {
+    return stop_search.load(std::memory_order_relaxed)
+        || stop_requests.pending();
+}
+
+void MctsAI::runIteration(const Board& root, Worker& worker) {
+    Board board = root;
+    std::vector<std::uint32_t>& path = worker.path;
+    path.clear();
+    path.push_back(0);
+    nodes[0].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+
+    // Selection: follow UCT down to a node that has not been expanded yet
+    std::uint32_t index = 0;
+    std::uint32_t prior_visits = 0;
+    while (nodes[index].state.load(std::memory_order_acquire) == Node::Expanded) {
+        index = selectChild(nodes[index]);
+        prior_visits = nodes[index].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+        board.makeMove(nodes[index].move);
+        path.push_back(index);
+    }
+
+    // Expansion: a leaf grows its children the second time it is reached, so single visits stay cheap
+    if (prior_visits > 0 && !board.isGameOver() && expand(nodes[index], board)) {
+        index = selectChild(nodes[index]);
+        nodes[index].visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+        board.makeMove(nodes[index].move);
+        path.push_back(index);
+    }
+
+    // Simulation and backpropagation
+    int winner = randomPlayout(board, worker.rng);
+    backpropagate(path, winner, root.getCurrentPlayer());
+}
+
+std::uint32_t MctsAI::selectChild(const Node& parent) const {
+    std::uint32_t best = parent.first_child;
+    double best_value = -1.0;
+    double log_visits = std::log(static_cast<double>(parent.visits.load(std::memory_order_relaxed)) + 1.0);
+    for (std::uint32_t i = 0; i < parent.num_children; ++i) {
+        std::uint32_t index = parent.first_child + i;
+        const Node& child = nodes[index];
+        std::uint32_t visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) return index; // Every child is tried once before any is revisited
+        double wins = child.wins.load(std::memory_order_relaxed);
+        double value = wins / visits + exploration * std::sqrt(log_visits / visits);
+        if (value > best_value) {
+            best_value = value;
+            best = index;
+        }
+    }
+    return best;
+}
+
+bool MctsAI::expand(Node& node, const Board& board) {
+    std::uint8_t expected = Node::Leaf;
+    if (!node.state.compare_exchange_strong(expected, Node::Expanding, std::memory_order_relaxed)) return false;
+
+    int mask = board.getLegalMoveMask();
+    std::size_t count = std::popcount(static_cast<unsigned>(mask));
+    std::size_t first = node_count.load(std::memory_order_relaxed);
+    do {
+        if (first + count > capacity) {
+            node.state.store(Node::Leaf, std::memory_order_relaxed); // Arena full: keep playing out from this leaf
+            return false;
+        }
+    } while (!node_count.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+
+    int first_id = board.getCurrentPlayer() * 5;
+    for (int k = 0, i = 0; k < 5; ++k) {
+        if (mask & (1 << k)) nodes[first + i++].reset(first_id + k);
+    }
+    node.first_child = static_cast<std::uint32_t>(first);
+    node.num_children = static_cast<std::uint8_t>(count);
+    // Publishes the children and the fields above to threads that see Expanded
+    node.state.store(Node::Expanded, std::memory_order_release);
+    return true;
+}
+
+void MctsAI::backpropagate(const std::vector<std::uint32_t>& path, int winner, int root_player) {
+    // The node at depth d was reached by a move of the root player when d is odd
+    for (std::size_t depth = 0; depth < path.size(); ++depth) {
+        Node& node = nodes[path[depth]];
+        int mover = depth % 2 == 1 ? root_player : 1 - root_player;
+        // Turn the virtual loss back into the single playout it stood for
+        node.visits.fetch_sub(VIRTUAL_LOSS - 1, std::memory_order_relaxed);
+        if (winner == mover) node.wins.fetch_add(1, std::memory_order_relaxed);
+    }
+}
@@ -1,4 +1,5 @@
 #include "MinimaxAI.hpp"
+#include "Playout.hpp"
 #include <limits>
 #include <algorithm>
 #include <iostream>
@@ -7,56 +8,264 @@
 #include <vector>
 #include <chrono>
 #include <future>
-#include <random> // Added for MCTS functionality
 #include <map>    // Added for MCTS functionality
+#include <stdexcept>
 
 std::mutex print_mutex; // Prevents simultaneous printing from multiple threads
 
-// A constant to control the influence of the MCTS score on the final combined score.
-MinimaxAI::MinimaxAI(size_t num_threads) : pool(num_threads) {
-    // The thread pool is initialized in the member initializer list
+struct MinimaxAI::SplitPoint {
+    Board board;          // Position at the split node; helpers search from a copy of it
+    int depth;
+    int moves[5];         // Younger siblings still to be shared out
+    int count;
+    int ply;
+    const SplitPoint* parent;
+    MoveOrdering ordering;       // Snapshot of the owner's ordering that helpers start from
+
+    std::atomic<int> next{0};    // Index of the next unclaimed sibling
+    std::atomic<int> alpha;      // Raised as siblings finish
+    const int beta;
+    std::atomic<bool> cutoff{false};
+
+    std::mutex mutex;            // Guards bestEval/bestMove and the alpha updates
+    int bestEval;
+    int bestMove;
+
+    SplitPoint(const Board& b, int d, int pl, int a, int bt, int eval, int move,
+               const int* siblings, int n, const SplitPoint* p, const MoveOrdering& o)
+        : board(b), depth(d), count(n), ply(pl), parent(p), ordering(o),
+          alpha(a), beta(bt), bestEval(eval), bestMove(move)
+    {
+        std::copy(siblings, siblings + n, moves);
+    }
+};
+
+namespace {
+
+// Runs search(alpha, beta) in a window centred on `guess`, widening whichever side failed
+// until the score lands inside. Shallow depths and unknown guesses use the full window.
+template<class Search, class Stopped>
+int searchWithAspiration(int depth, int guess, int window, int min_depth, int infinity,
+                         Search&& search, Stopped&& stopped) {
+    if (depth < min_depth) return search(-infinity, infinity);
+
+    int delta = window;
+    int alpha = std::max(guess - delta, -infinity);
+    int beta = std::min(guess + delta, infinity);
+    while (true) {
+        int score = search(alpha, beta);
+        if (stopped()) return score;
+        if (score <= alpha && alpha > -infinity) {
+            alpha = std::max(score - delta, -infinity);
+        } else if (score >= beta && beta < infinity) {
+            beta = std::min(score + delta, infinity);
+        } else {
+            return score;
+        }
+        delta *= 2;
+    }
+}
+
+// Logs that iterative deepening stops before starting `depth`
+void reportStop(const SearchTimer& timer, int depth) {
+    std::lock_guard<std::mutex> lock(print_mutex);
+    std::cout << "Stopping after " << timer.elapsed().count() << "s: depth " << depth << " would need about "
+              << timer.predictedIteration().count() << "s more. Using best move from depth " << (depth - 1) << ".\n";
+}
+
+// Logs that `depth` was stopped, by the clock or by stop(), and its partial result is dropped
+void reportAbort(int depth) {
+    std::lock_guard<std::mutex> lock(print_mutex);
+    std::cout << "Depth " << depth << " aborted. Using best move from depth " << (depth - 1) << ".\n";
+}
+
+} // namespace
+
+MinimaxAI::MinimaxAI(size_t num_threads, size_t tt_size_mb, SearchMode mode)
+    : MinimaxAI(std::make_shared<TranspositionTable>(tt_size_mb), num_threads, mode)
+{
+    shared_table = false;
+}
+
+MinimaxAI::MinimaxAI(std::shared_ptr<TranspositionTable> table, size_t num_threads, SearchMode mode)
+    : pool(mode == SearchMode::Sequential ? nullptr : std::make_unique<ThreadPool>(num_threads)),
+      tt(std::move(table)),
+      shared_table(true),
+      search_mode(mode),
+      rollout_blend(mode == SearchMode::RootSplit)
+{
+}
+
+MinimaxAI::~MinimaxAI() {
+    // The ponder thread uses the pool and the table, so it must finish before they go
+    stopPondering();
+}
+
+void MinimaxAI::setTablebase(std::shared_ptr<const Tablebase> tablebase) {
+    this->tablebase = std::move(tablebase);
+}
+
+void MinimaxAI::setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+    opening_book = std::move(book);
+}
+
+void MinimaxAI::setRolloutBlend(bool enabled) {
+    if (enabled && search_mode != SearchMode::RootSplit) {
+        throw std::invalid_argument("the rollout blend needs the RootSplit search mode");
+    }
+    rollout_blend = enabled;
+}
+
+bool MinimaxAI::stopRequested() const {
+    return stop_search.load(std::memory_order_relaxed)
+        || stop_requests.pending();
+}
+
+bool MinimaxAI::shouldStop(const std::chrono::steady_clock::time_point& start_time,
+                           const std::chrono::duration<double>& time_limit) {
+    if (stopRequested()) return true;
+
+    // Reading the clock costs more than the rest of a node, so each thread only looks at it
+    // every CLOCK_CHECK_INTERVAL calls; whichever thread sees the time run out stops them all
+    thread_local std::uint32_t calls = 0;
+    if (++calls % CLOCK_CHECK_INTERVAL != 0) return false;
+    if (std::chrono::steady_clock::now() - start_time <= time_limit) return false;
+    stop_search.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void MinimaxAI::stop() {
+    stop_requests.request();
+}
+
+void MinimaxAI::startPondering(const Board& board) {
+    std::lock_guard<std::mutex> lock(ponder_mutex);
+    stopPonderingLocked();
+    if (board.getLegalMoveMask() == 0) return;
+
+    stop_search.store(false, std::memory_order_relaxed);
+    ponder_thread = std::thread([this, board]() {
+        StopRequests::Scope stop_scope(stop_requests);
+        {
+            std::lock_guard<std::mutex> print_lock(print_mutex);
+            std::cout << "Pondering on the opponent's time...\n";
+        }
+        // No real clock applies: the search runs until it is stopped
+        if (!shared_table) tt->newSearch();
+        runSearch(board, NO_TIME_LIMIT, std::chrono::steady_clock::now(), true);
+    });
 }
 
-int MinimaxAI::findBestMove(const Board& board, const std::chrono::duration<double>& time_limit) {
+void MinimaxAI::stopPondering() {
+    std::lock_guard<std::mutex> lock(ponder_mutex);
+    stopPonderingLocked();
+}
+
+void MinimaxAI::stopPonderingLocked() {
+    if (!ponder_thread.joinable()) return;
+    stop_search.store(true, std::memory_order_relaxed);
+    ponder_thread.join();
+}
+
+int MinimaxAI::findBestMove(const Board& board, const MoveBudget& budget) {
     auto start_time = std::chrono::steady_clock::now();
-    
-    auto legalMoves = board.getLegalMoves();
-    if (legalMoves.empty()) return -1;
 
+    // Whatever pondering found is in the table by now. Stopped first, so the ponder search
+    // re-arms before this one takes over the stop requests.
+    stopPondering();
+    StopRequests::Scope stop_scope(stop_requests);
+
+    if (board.getLegalMoveMask() == 0) return -1;
+
+    if (opening_book) {
+        int book_move = opening_book->probe(board);
+        if (book_move != -1) {
+            std::cout << "Book move: " << book_move << "\n";
+            return book_move;
+        }
+    }
+
+    // A shared table is aged by its owner: every engine ageing it would wrap the generation
+    if (!shared_table) {
+        tt->newSearch();
+        tt->resetStats();
+    }
+    main_ordering.age();
+    stop_search.store(false, std::memory_order_relaxed);
+
+    int best_move = runSearch(board, budget, start_time, false);
+    if (shared_table) return best_move;
+
+    auto tt_stats = tt->getStats();
+    std::cout << "TT: " << tt_stats.probes << " probes, " << tt_stats.hits << " hits ("
+              << (tt_stats.probes ? 100.0 * tt_stats.hits / tt_stats.probes : 0.0) << "%), "
+              << tt_stats.stores << " stores, " << tt_stats.replacements << " replacements.\n";
+
+    return best_move;
+}
+
+int MinimaxAI::runSearch(const Board& board, const MoveBudget& budget,
+                         const std::chrono::steady_clock::time_point& start_time, bool pondering) {
+    switch (search_mode) {
+        case SearchMode::LazySmp:
+            return findBestMoveLazySmp(board, budget, start_time, pondering);
+        case SearchMode::SplitPoint:
+        case SearchMode::Sequential:
+            return iterativeDeepening(board, budget, start_time, pondering);
+        default:
+            return findBestMoveRootSplit(board, budget, start_time, pondering);
+    }
+}
+
+int MinimaxAI::findBestMoveRootSplit(const Board& board, const MoveBudget& budget,
+                                     const std::chrono::steady_clock::time_point& start_time, bool pondering) {
+    auto legalMoves = board.getLegalMoves();
     int best_move_overall = legalMoves[0];
+    SearchTimer timer(budget, start_time);
 
     bool isMaximizing = (board.getCurrentPlayer() == 0);
+    bool blend = rollout_blend && !pondering;
+
+    // Each root move's previous-depth score seeds its aspiration window, and its
+    // ordering tables carry over from one depth to the next
+    std::vector<int> previous_scores(legalMoves.size(), 0);
+    std::vector<MoveOrdering> orderings(legalMoves.size());
     
     for (int depth = 1; depth < 30; ++depth) {
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        if (elapsed > time_limit * 0.8) {
-            std::cout << "Time limit approaching: "
-                      << std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count()
-                      << "s. Using best move from depth " << (depth - 1) << ".\n";
+        if (stopRequested()) break;
+        if (!timer.shouldStartIteration()) {
+            if (!pondering) reportStop(timer, depth);
             break;
         }
+        // The clock never cuts depth 1 short, so only stop() can leave the move unsearched
+        const std::chrono::duration<double> time_limit = depth == 1 ? NO_TIME_LIMIT : budget.maximum;
 
         std::vector<std::future<int>> futures;
-        for (int move : legalMoves) {
-            // Enqueue the minimax search for each move as a task
+        for (size_t i = 0; i < legalMoves.size(); ++i) {
+            int move = legalMoves[i];
+            int* previous_score = &previous_scores[i];
+            MoveOrdering* ordering = &orderings[i];
+            // Enqueue the search for each move as a task
             futures.emplace_back(
-                pool.enqueue([this, &board, depth, isMaximizing, start_time, time_limit, move]() {
-                    auto nextBoard = board.clone();
-                    nextBoard->makeMove(move);
-                    
-                    int minimax_score = minimax(*nextBoard, depth - 1, !isMaximizing,
-                                                std::numeric_limits<int>::min(),
-                                                std::numeric_limits<int>::max(),
-                                                start_time, time_limit);
-                    
-                    // The number of MCTS rollouts to perform.
-                    // This can be adjusted based on performance needs.
-                    const int NUM_MCTS_ROLLOUTS = 500;
-                    int mcts_score = mctsRollout(*nextBoard, NUM_MCTS_ROLLOUTS);
-                    
+                pool->enqueue([this, &board, depth, isMaximizing, blend, start_time, time_limit, move, previous_score, ordering]() {
+                    Board nextBoard = board;
+                    nextBoard.makeMove(move);
+
+                    // Scored from the root player's side, then turned back into player 0's view
+                    int score = searchWithAspiration(depth, *previous_score, ASPIRATION_WINDOW,
+                        ASPIRATION_MIN_DEPTH, SCORE_INFINITY,
+                        [&](int alpha, int beta) {
+                            return -negamax(nextBoard, *ordering, depth - 1, 1, -beta, -alpha, start_time, time_limit);
+                        },
+                        [&] { return shouldStop(start_time, time_limit); });
+                    *previous_score = score;
+                    int minimax_score = isMaximizing ? score : -score;
+                    if (!blend) return minimax_score;
+
+                    int mcts_score = mctsRollout(nextBoard, BLEND_ROLLOUTS);
                     int combined_score = static_cast<int>(
                         0.7 * minimax_score +
-                        0.3 * (mcts_score / NUM_MCTS_ROLLOUTS) * (60 - depth)
+                        0.3 * (mcts_score / BLEND_ROLLOUTS) * (60 - depth)
                     );
                     
                     return combined_score;
@@ -70,6 +279,13 @@ int MinimaxAI::findBestMove(const Board& board, const std::chrono::duration<doub
             move_values.push_back(future.get());
         }
 
+        // Root moves searched after the stop hold static evaluations, not scores. Only a stop
+        // the search saw counts: reading the clock again could drop a finished iteration.
+        if (stopRequested()) {
+            if (!pondering) reportAbort(depth);
+            break;
+        }
+
         int best_move_this_depth = -1;
         int best_value = isMaximizing ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
 
@@ -80,113 +296,324 @@ int MinimaxAI::findBestMove(const Board& board, const std::chrono::duration<doub
             }
         }
         
-        std::lock_guard<std::mutex> lock(print_mutex);
-        std::cout << "Depth " << depth << " search completed. ";
-        std::cout << "Best move is: " << best_move_this_depth
-                  << " with value: " << best_value << "\n";
+        if (!pondering) {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << "Depth " << depth << " search completed. ";
+            std::cout << "Best move is: " << best_move_this_depth
+                      << " with value: " << best_value << "\n";
+        }
         
         best_move_overall = best_move_this_depth;
+        timer.iterationCompleted(best_move_this_depth);
     }
 
     return best_move_overall;
 }
 
-int MinimaxAI::minimax(const Board& board, int depth, bool isMaximizingPlayer,
-                       int alpha, int beta,
-                       const std::chrono::steady_clock::time_point& start_time,
-                       const std::chrono::duration<double>& time_limit)
-{
-    auto now = std::chrono::steady_clock::now();
-    if (now - start_time > time_limit * 0.8) {
-        return evaluateState(board); 
+int MinimaxAI::findBestMoveLazySmp(const Board& board, const MoveBudget& budget,
+                                   const std::chrono::steady_clock::time_point& start_time, bool pondering) {
+    // Helpers have no iterations of their own to time; they run until the main search is done.
+    // Only the main search reads the clock, so a helper seeing the deadline pass just after
+    // the main search finished an iteration cannot get that iteration thrown away.
+    const std::chrono::duration<double> time_limit = NO_TIME_LIMIT;
+
+    // The calling thread is the main search, so one pool worker fewer keeps every core busy
+    size_t num_helpers = pool->size() > 1 ? pool->size() - 1 : 0;
+
+    std::vector<std::future<void>> helpers;
+    for (size_t i = 0; i < num_helpers; ++i) {
+        helpers.emplace_back(pool->enqueue([this, &board, i, start_time, time_limit]() {
+            // Odd helpers run one ply ahead of the main thread so the threads spread over depths
+            Board helperBoard = board;
+            MoveOrdering ordering;
+            int rotation = static_cast<int>(i) + 1;
+            int bestMove = -1;
+            int score = 0;
+            for (int depth = 1 + static_cast<int>(i % 2); depth < 30 && !shouldStop(start_time, time_limit); ++depth) {
+                score = searchWithAspiration(depth, score, ASPIRATION_WINDOW, ASPIRATION_MIN_DEPTH, SCORE_INFINITY,
+                    [&](int alpha, int beta) {
+                        return searchRoot(helperBoard, ordering, depth, rotation, alpha, beta, bestMove, start_time, time_limit);
+                    },
+                    [&] { return shouldStop(start_time, time_limit); });
+            }
+        }));
     }
 
-    if (depth == 0 || board.isGameOver()) return evaluateState(board);
+    int best_move_overall = iterativeDeepening(board, budget, start_time, pondering);
 
-    auto legalMoves = board.getLegalMoves();
-    if (legalMoves.empty()) return evaluateState(board);
-
-    if (isMaximizingPlayer) {
-        int maxEval = std::numeric_limits<int>::min();
-        for (int move : legalMoves) {
-            auto nextBoard = board.clone();
-            nextBoard->makeMove(move);
-            int eval = minimax(*nextBoard, depth - 1, false, alpha, beta, start_time, time_limit);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-            if (beta <= alpha) break;
-        }
-        return maxEval;
-    } else {
-        int minEval = std::numeric_limits<int>::max();
-        for (int move : legalMoves) {
-            auto nextBoard = board.clone();
-            nextBoard->makeMove(move);
-            int eval = minimax(*nextBoard, depth - 1, true, alpha, beta, start_time, time_limit);
-            minEval = std::min(minEval, eval);
-            beta = std::min(beta, eval);
-            if (beta <= alpha) break;
+    // The search is over, so the helpers are stopped like any other search
+    stop_search.store(true, std::memory_order_relaxed);
+    for (auto& helper : helpers) {
+        helper.get();
+    }
+
+    return best_move_overall;
+}
+
+int MinimaxAI::iterativeDeepening(const Board& board, const MoveBudget& budget,
+                                  const std::chrono::steady_clock::time_point& start_time, bool pondering) {
+    Board searchBoard = board;
+    int best_move_overall = board.getLegalMoves()[0];
+    int previous_score = 0;
+    SearchTimer timer(budget, start_time);
+    for (int depth = 1; depth < 30; ++depth) {
+        if (!timer.shouldStartIteration()) {
+            if (!pondering) reportStop(timer, depth);
+            break;
+        }
+        // The clock never cuts depth 1 short, so only stop() can leave the move unsearched
+        const std::chrono::duration<double> time_limit = depth == 1 ? NO_TIME_LIMIT : budget.maximum;
+
+        int best_move_this_depth = -1;
+        int score = searchWithAspiration(depth, previous_score, ASPIRATION_WINDOW, ASPIRATION_MIN_DEPTH, SCORE_INFINITY,
+            [&](int alpha, int beta) {
+                return searchRoot(searchBoard, main_ordering, depth, 0, alpha, beta, best_move_this_depth,
+                                  start_time, time_limit);
+            },
+            [&] { return shouldStop(start_time, time_limit); });
+
+        // An iteration cut short has not looked at every root move properly. As in RootSplit,
+        // only a stop the search saw counts, not a deadline passing after it finished.
+        if (stopRequested()) {
+            if (!pondering) reportAbort(depth);
+            break;
         }
-        return minEval;
+        previous_score = score;
+        int best_value = board.getCurrentPlayer() == 0 ? score : -score; // Reported from player 0's view
+
+        if (!pondering) {
+            std::lock_guard<std::mutex> lock(print_mutex);
+            std::cout << "Depth " << depth << " search completed. ";
+            std::cout << "Best move is: " << best_move_this_depth
+                      << " with value: " << best_value << "\n";
+        }
+
+        best_move_overall = best_move_this_depth;
+        timer.iterationCompleted(best_move_this_depth);
     }
+
+    return best_move_overall;
 }
 
-// Function to perform a Monte Carlo Tree Search rollout.
-int MinimaxAI::mctsRollout(const Board& board, int num_simulations) const {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    
-    int wins = 0;
-    int losses = 0;
+int MinimaxAI::searchRoot(Board& board, MoveOrdering& ordering, int depth, int rotation, int alpha, int beta, int& bestMove,
+                          const std::chrono::steady_clock::time_point& start_time,
+                          const std::chrono::duration<double>& time_limit)
+{
+    TTEntry entry;
+    int hash_move = tt->probe(board.getHash(), entry) ? entry.move : -1;
+    int order[5];
+    int count = ordering.orderMoves(board, hash_move, 0, rotation, order);
 
-    for (int i = 0; i < num_simulations; ++i) {
-        auto tempBoard = board.clone();
-        
-        while (!tempBoard->isGameOver()) {
-            auto moves = tempBoard->getLegalMoves();
-            if (moves.empty()) break;
-            
-            std::uniform_int_distribution<> distrib(0, moves.size() - 1);
-            int random_move = moves[distrib(gen)];
-            
-            tempBoard->makeMove(random_move);
+    const int alphaOrig = alpha;
+    int bestEval;
+    if (search_mode == SearchMode::SplitPoint && depth >= MIN_SPLIT_DEPTH && count > 1) {
+        bestEval = searchSplitPoint(board, ordering, depth, 0, alpha, beta, order, count, bestMove,
+                                    nullptr, start_time, time_limit);
+    } else {
+        bestEval = searchMoves(board, ordering, depth, 0, alpha, beta, order, count, bestMove,
+                               nullptr, start_time, time_limit);
+    }
+
+    if (!stopRequested()) {
+        Bound bound = bestEval <= alphaOrig ? Bound::Upper
+                    : bestEval >= beta      ? Bound::Lower
+                    : Bound::Exact;
+        tt->store(board.getHash(), depth, bound, bestEval, bestMove);
+    }
+    return bestEval;
+}
+
+int MinimaxAI::searchChild(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                           bool firstMove, const SplitPoint* parent,
+                           const std::chrono::steady_clock::time_point& start_time,
+                           const std::chrono::duration<double>& time_limit)
+{
+    if (firstMove) {
+        return -negamax(board, ordering, depth - 1, ply + 1, -beta, -alpha, start_time, time_limit, parent);
+    }
+    // Later moves only need to be proven no better than alpha; re-search the ones that are
+    int eval = -negamax(board, ordering, depth - 1, ply + 1, -alpha - 1, -alpha, start_time, time_limit, parent);
+    if (eval > alpha && eval < beta) {
+        eval = -negamax(board, ordering, depth - 1, ply + 1, -beta, -alpha, start_time, time_limit, parent);
+    }
+    return eval;
+}
+
+int MinimaxAI::searchMoves(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                           const int order[5], int count, int& bestMove, const SplitPoint* parent,
+                           const std::chrono::steady_clock::time_point& start_time,
+                           const std::chrono::duration<double>& time_limit)
+{
+    int bestEval = -SCORE_INFINITY;
+    bestMove = order[0];
+    for (int i = 0; i < count; ++i) {
+        auto undo = board.makeMove(order[i]);
+        int eval = searchChild(board, ordering, depth, ply, alpha, beta, i == 0, parent, start_time, time_limit);
+        board.unmakeMove(undo);
+        if (eval > bestEval) {
+            bestEval = eval;
+            bestMove = order[i];
+        }
+        alpha = std::max(alpha, eval);
+        if (alpha >= beta) {
+            ordering.recordCutoff(board, order[i], ply, depth);
+            break;
         }
+    }
+    return bestEval;
+}
+
+bool MinimaxAI::cutoffOccurred(const SplitPoint* sp) {
+    for (; sp != nullptr; sp = sp->parent) {
+        if (sp->cutoff.load(std::memory_order_relaxed)) return true;
+    }
+    return false;
+}
 
-        int winner = tempBoard->getWinner();
-        if (winner == 0) { // MAX player wins
-            wins++;
-        } else if (winner == 1) { // MIN player wins
-            losses++;
+int MinimaxAI::searchSplitPoint(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                                const int order[5], int count, int& bestMove, const SplitPoint* parent,
+                                const std::chrono::steady_clock::time_point& start_time,
+                                const std::chrono::duration<double>& time_limit)
+{
+    // The eldest brother is searched alone to establish a bound for the others
+    auto undo = board.makeMove(order[0]);
+    int bestEval = searchChild(board, ordering, depth, ply, alpha, beta, true, parent, start_time, time_limit);
+    board.unmakeMove(undo);
+    bestMove = order[0];
+
+    alpha = std::max(alpha, bestEval);
+    if (alpha >= beta) {
+        ordering.recordCutoff(board, bestMove, ply, depth);
+        return bestEval;
+    }
+    if (shouldStop(start_time, time_limit) || cutoffOccurred(parent)) return bestEval;
+
+    SplitPoint sp(board, depth, ply, alpha, beta, bestEval, bestMove, order + 1, count - 1, parent, ordering);
+
+    // This thread takes a sibling too, so at most count - 2 helpers are useful. A helper
+    // that starts after every sibling is claimed returns at once. wait() runs queued pool
+    // work instead of blocking, so nested splits keep every thread busy.
+    ThreadPool::TaskGroup helpers(*pool);
+    size_t num_helpers = std::min(static_cast<size_t>(count - 2), pool->size());
+    for (size_t i = 0; i < num_helpers; ++i) {
+        helpers.run([this, &sp, start_time, time_limit]() {
+            Board helperBoard = sp.board;
+            MoveOrdering helperOrdering = sp.ordering;
+            helpSplitPoint(sp, helperBoard, helperOrdering, start_time, time_limit);
+        });
+    }
+    helpSplitPoint(sp, board, ordering, start_time, time_limit);
+    helpers.wait();
+
+    bestMove = sp.bestMove;
+    return sp.bestEval;
+}
+
+void MinimaxAI::helpSplitPoint(SplitPoint& sp, Board& board, MoveOrdering& ordering,
+                               const std::chrono::steady_clock::time_point& start_time,
+                               const std::chrono::duration<double>& time_limit)
+{
+    for (int index = sp.next.fetch_add(1); index < sp.count; index = sp.next.fetch_add(1)) {
+        if (cutoffOccurred(&sp) || shouldStop(start_time, time_limit)) return;
+
+        auto undo = board.makeMove(sp.moves[index]);
+        int eval = searchChild(board, ordering, sp.depth, sp.ply, sp.alpha.load(), sp.beta, false, &sp,
+                               start_time, time_limit);
+        board.unmakeMove(undo);
+
+        if (cutoffOccurred(&sp)) return;
+        std::lock_guard<std::mutex> lock(sp.mutex);
+        if (eval > sp.bestEval) {
+            sp.bestEval = eval;
+            sp.bestMove = sp.moves[index];
+        }
+        sp.alpha.store(std::max(sp.alpha.load(), eval));
+        if (sp.alpha.load() >= sp.beta) {
+            ordering.recordCutoff(board, sp.moves[index], sp.ply, sp.depth);
+            sp.cutoff.store(true);
         }
     }
-    
-    return wins - losses;
 }
 
+int MinimaxAI::negamax(Board& board, MoveOrdering& ordering, int depth, int ply, int alpha, int beta,
+                       const std::chrono::steady_clock::time_point& start_time,
+                       const std::chrono::duration<double>& time_limit,
+                       const SplitPoint* parent)
+{
+    if (shouldStop(start_time, time_limit) || cutoffOccurred(parent)) {
+        return evaluateForSideToMove(board); 
+    }
 
-// --- Evaluate State ---
-int MinimaxAI::evaluateState(const Board& board) const {
-    int winner = board.getWinner();
-    if (winner == 0) return 1000;
-    if (winner == 1) return -1000;
+    if (board.isGameOver()) return evaluateForSideToMove(board);
 
-    int score = 0;
-    const auto& pieces = board.getPieces();
-    int p0_returned = 0, p1_returned = 0;
+    // Endgames in the tablebase are solved exactly, whatever depth is left
+    int distance;
+    if (tablebase && tablebase->probe(board, distance)) return tablebaseScore(distance);
 
-    for (const auto& p : pieces) {
-        int piece_score = p.has_turned_around ? (6 - p.position) * 2 + 10 : p.position;
-        if (p.player == 0) score += piece_score;
-        else score -= piece_score;
+    if (depth == 0 || board.getLegalMoveMask() == 0) return evaluateForSideToMove(board);
 
-        if (p.position == 0 && p.has_turned_around) {
-            if (p.player == 0) p0_returned++;
-            else p1_returned++;
+    // A deep enough stored result may settle this node outright or narrow the window
+    int hash_move = -1;
+    TTEntry entry;
+    if (tt->probe(board.getHash(), entry)) {
+        hash_move = entry.move;
+        if (entry.depth >= depth) {
+            if (entry.bound == Bound::Exact) return entry.score;
+            if (entry.bound == Bound::Lower) alpha = std::max(alpha, entry.score);
+            else if (entry.bound == Bound::Upper) beta = std::min(beta, entry.score);
+            if (alpha >= beta) return entry.score;
         }
     }
+    const int alphaOrig = alpha;
 
-    score += p0_returned * 30;
-    score -= p1_returned * 30;
+    int order[5];
+    int count = ordering.orderMoves(board, hash_move, ply, 0, order);
+
+    int bestEval;
+    int bestMove = -1;
+    if (search_mode == SearchMode::SplitPoint && depth >= MIN_SPLIT_DEPTH && count > 1) {
+        bestEval = searchSplitPoint(board, ordering, depth, ply, alpha, beta, order, count, bestMove,
+                                    parent, start_time, time_limit);
+    } else {
+        bestEval = searchMoves(board, ordering, depth, ply, alpha, beta, order, count, bestMove,
+                               parent, start_time, time_limit);
+    }
+
+    // Results of a search cut short by the clock or a cutoff are unreliable, so keep them out of the table
+    if (!stopRequested() && !cutoffOccurred(parent)) {
+        Bound bound = bestEval <= alphaOrig ? Bound::Upper
+                    : bestEval >= beta      ? Bound::Lower
+                    : Bound::Exact;
+        tt->store(board.getHash(), depth, bound, bestEval, bestMove);
+    }
+    return bestEval;
+}
+
+// Function to perform a Monte Carlo Tree Search rollout.
+int MinimaxAI::mctsRollout(const Board& board, int num_simulations) const {
+    // Every game has a winner, so wins - losses follows from player 0's wins alone
+    int wins = countPlayoutWins(board, num_simulations, threadRng());
+    return wins - (num_simulations - wins);
+}
+
+
+int MinimaxAI::evaluateForSideToMove(const Board& board) const {
+    int score = evaluateState(board);
+    return board.getCurrentPlayer() == 0 ? score : -score;
+}
+
+int MinimaxAI::tablebaseScore(int distance) {
+    if (distance > 0) return WIN_SCORE - distance;
+    if (distance < 0) return -WIN_SCORE - distance;
+    return 0;
+}
+
+// --- Evaluate State ---
+int MinimaxAI::evaluateState(const Board& board) const {
+    int winner = board.getWinner();
+    if (winner == 0) return WIN_SCORE;
+    if (winner == 1) return -WIN_SCORE;
 
-    return score;
+    // Piece progress and the bonus for returned pieces, kept up to date by the board
+    return board.getScore();
 }
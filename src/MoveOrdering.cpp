@@ -0,0 +1,86 @@
+#include "MoveOrdering.hpp"
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+constexpr int HASH_MOVE_SCORE = 1 << 30;
+constexpr int JUMP_SCORE = 1 << 24;   // Plus the number of opponents jumped
+constexpr int KILLER_SCORE = 1 << 20; // Plus one for the most recent killer
+
+} // namespace
+
+MoveOrdering::MoveOrdering() {
+    clear();
+}
+
+void MoveOrdering::clear() {
+    for (auto& slots : killers) {
+        slots[0] = slots[1] = -1;
+    }
+    for (auto& piece : history) {
+        std::fill(std::begin(piece), std::end(piece), 0);
+    }
+}
+
+void MoveOrdering::age() {
+    for (auto& slots : killers) {
+        slots[0] = slots[1] = -1;
+    }
+    halveHistory();
+}
+
+void MoveOrdering::halveHistory() {
+    for (auto& piece : history) {
+        for (int& score : piece) score /= 2;
+    }
+}
+
+int MoveOrdering::orderMoves(const Board& board, int hash_move, int ply, int rotation, int order[5]) const {
+    int legalMoves = board.getLegalMoveMask();
+    int first_id = board.getCurrentPlayer() * 5;
+    const int* killer = killers[std::min(ply, MAX_PLY - 1)];
+
+    int scores[5];
+    int count = 0;
+    for (int i = 0; i < 5; ++i) {
+        int slot = (i + rotation) % 5;
+        if (!((legalMoves >> slot) & 1)) continue;
+
+        int move = first_id + slot;
+        int score;
+        if (move == hash_move) {
+            score = HASH_MOVE_SCORE;
+        } else if (int resets = board.getMoveTransition(move).resets; resets != 0) {
+            score = JUMP_SCORE + std::popcount(static_cast<unsigned>(resets));
+        } else if (move == killer[0]) {
+            score = KILLER_SCORE + 1;
+        } else if (move == killer[1]) {
+            score = KILLER_SCORE;
+        } else {
+            score = history[move][board.getProgress(move)];
+        }
+
+        // Insertion sort, stable so equal scores keep the rotated id order
+        int j = count++;
+        for (; j > 0 && scores[j - 1] < score; --j) {
+            scores[j] = scores[j - 1];
+            order[j] = order[j - 1];
+        }
+        scores[j] = score;
+        order[j] = move;
+    }
+    return count;
+}
+
+void MoveOrdering::recordCutoff(const Board& board, int move, int ply, int depth) {
+    // Jumps are already ordered early, so only quiet moves become killers
+    if (board.getMoveTransition(move).resets == 0 && ply < MAX_PLY && killers[ply][0] != move) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int& score = history[move][board.getProgress(move)];
+    score += depth * depth;
+    if (score > HISTORY_LIMIT) halveHistory();
+}
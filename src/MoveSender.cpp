@@ -0,0 +1,64 @@
+#include "MoveSender.hpp"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include "httplib.h"
+
+namespace {
+
+// Failures where the request cannot have reached the GUI, so sending it again is safe. A
+// read error is not retried: the GUI may already have played the move.
+bool isRetryable(httplib::Error error) {
+    return error == httplib::Error::Connection || error == httplib::Error::ConnectionTimeout ||
+           error == httplib::Error::Write;
+}
+
+} // namespace
+
+MoveSender::MoveSender(const std::string& host, int port, const HttpClientOptions& options)
+    : options(options),
+      cli(std::make_unique<httplib::Client>(host, port))
+{
+    cli->set_keep_alive(true);
+    cli->set_connection_timeout(options.connection_timeout);
+    cli->set_read_timeout(options.read_timeout);
+}
+
+MoveSender::~MoveSender() = default;
+
+bool MoveSender::send(const std::string& path, const std::string& json_string) {
+    auto start = std::chrono::steady_clock::now();
+    auto backoff = options.retry_backoff;
+
+    for (int attempt = 0;; ++attempt) {
+        std::unique_lock<std::mutex> lock(client_mutex);
+        auto res = cli->Post(path, json_string, "application/json");
+
+        if (res && res->status == 200) {
+            std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - start;
+            ++requests;
+            total_latency += latency;
+            max_latency = std::max(max_latency, latency);
+            std::cout << "Move sent in " << latency.count() << " ms (average "
+                      << total_latency.count() / requests << " ms, max "
+                      << max_latency.count() << " ms over " << requests << " moves).\n";
+            return true;
+        }
+        lock.unlock();
+
+        if (res) {
+            std::cerr << "Server rejected move." << std::endl;
+            std::cerr << "Status code: " << res->status << std::endl;
+            return false;
+        }
+        std::cerr << "Error: " << httplib::to_string(res.error()) << std::endl;
+        if (!isRetryable(res.error()) || attempt >= options.max_retries) {
+            std::cerr << "Failed to send move." << std::endl;
+            return false;
+        }
+
+        std::cerr << "Retrying in " << backoff.count() << " ms..." << std::endl;
+        std::this_thread::sleep_for(backoff);
+        backoff *= 2;
+    }
+}
@@ -0,0 +1,76 @@
+#include "OpeningBook.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+// On-disk layout: this header followed by the sorted entries
+struct FileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t entries;
+};
+
+constexpr char FILE_MAGIC[4] = {'S', 'Q', 'O', 'B'};
+constexpr std::uint32_t FILE_VERSION = 1;
+
+bool keyMoveLess(const OpeningBook::Entry& a, const OpeningBook::Entry& b) {
+    return a.key != b.key ? a.key < b.key : a.move < b.move;
+}
+
+} // namespace
+
+void OpeningBook::save(const std::string& path, std::vector<Entry> entries) {
+    std::sort(entries.begin(), entries.end(), keyMoveLess);
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open opening book file for writing: " + path);
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.entries = entries.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    if (!out) throw std::runtime_error("Failed writing opening book file: " + path);
+}
+
+void OpeningBook::load(const std::string& path) {
+    auto mapped = std::make_unique<MappedFile>(path, false);
+
+    FileHeader header{};
+    if (mapped->size() < sizeof(header)) throw std::runtime_error("Not a Squadro opening book file: " + path);
+    std::memcpy(&header, mapped->data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION) {
+        throw std::runtime_error("Not a Squadro opening book file: " + path);
+    }
+    if (mapped->size() != sizeof(header) + header.entries * sizeof(Entry)) {
+        throw std::runtime_error("Opening book file has the wrong size: " + path);
+    }
+
+    file = std::move(mapped);
+    entries = reinterpret_cast<const Entry*>(file->data() + sizeof(header));
+    entry_count = header.entries;
+}
+
+int OpeningBook::probe(const Board& board) const {
+    std::uint64_t key = board.getHash();
+    const Entry* end = entries + entry_count;
+    const Entry* first = std::lower_bound(entries, end, key,
+        [](const Entry& entry, std::uint64_t value) { return entry.key < value; });
+
+    const Entry* best = nullptr;
+    for (const Entry* entry = first; entry != end && entry->key == key; ++entry) {
+        if (!best || entry->games > best->games) best = entry;
+    }
+    if (!best || best->games < MIN_GAMES) return -1;
+    if (best->wins < MIN_WIN_RATE * best->games) return -1;
+
+    // Guards against a hash collision with a position where the move is not playable
+    int piece = best->move;
+    if (piece < 0 || piece >= Board::NUM_PIECES || piece / 5 != board.getCurrentPlayer()) return -1;
+    if (!(board.getLegalMoveMask() & (1 << (piece % 5)))) return -1;
+    return piece;
+}
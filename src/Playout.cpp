@@ -0,0 +1,193 @@
+#include "Playout.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <random>
+#include <thread>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SQUADRO_HAS_AVX2_PLAYOUTS 1
+#include <immintrin.h>
+#endif
+
+Xoshiro256& threadRng() {
+    thread_local Xoshiro256 rng(
+        (static_cast<std::uint64_t>(std::random_device{}()) << 32)
+        ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    return rng;
+}
+
+int randomPlayout(Board board, Xoshiro256& rng) {
+    // A game only ends when a piece comes home, so count returns instead of rescanning the board
+    int returned[2] = {0, 0};
+    for (int id = 0; id < Board::NUM_PIECES; ++id) {
+        if (board.getProgress(id) == Board::PROGRESS_RETURNED) ++returned[id / 5];
+    }
+
+    while (returned[0] < 4 && returned[1] < 4) {
+        int player = board.getCurrentPlayer();
+        unsigned mask = static_cast<unsigned>(board.getLegalMoveMask());
+        // Drop a random number of the lowest set bits, then take the lowest remaining one
+        for (std::uint32_t n = rng.below(std::popcount(mask)); n > 0; --n) mask &= mask - 1;
+        int piece = player * 5 + std::countr_zero(mask);
+
+        board.makeMove(piece);
+        if (board.getProgress(piece) == Board::PROGRESS_RETURNED) ++returned[player];
+    }
+    return returned[0] >= 4 ? 0 : 1;
+}
+
+namespace {
+
+int countPlayoutWinsScalar(const Board& board, int num_playouts, Xoshiro256& rng) {
+    int wins = 0;
+    for (int i = 0; i < num_playouts; ++i) {
+        if (randomPlayout(board, rng) == 0) ++wins;
+    }
+    return wins;
+}
+
+#ifdef SQUADRO_HAS_AVX2_PLAYOUTS
+
+constexpr int LANES = 8;
+constexpr int OCCUPANCIES = 32;
+
+// The move table flattened for gathers: entry (piece * 13 + progress) * 32 + occupancy
+// holds destination | resets << 8
+using FlatMoveTable = std::array<std::int32_t, Board::NUM_PIECES * (Board::PROGRESS_RETURNED + 1) * OCCUPANCIES>;
+
+const FlatMoveTable& flatMoveTable() {
+    static const FlatMoveTable table = [] {
+        FlatMoveTable flat{};
+        for (int id = 0; id < Board::NUM_PIECES; ++id) {
+            for (int progress = 0; progress <= Board::PROGRESS_RETURNED; ++progress) {
+                for (int occupancy = 0; occupancy < OCCUPANCIES; ++occupancy) {
+                    Board::MoveTransition t = Board::lookupMoveTransition(id, progress, occupancy);
+                    flat[(id * (Board::PROGRESS_RETURNED + 1) + progress) * OCCUPANCIES + occupancy] =
+                        t.destination | t.resets << 8;
+                }
+            }
+        }
+        return flat;
+    }();
+    return table;
+}
+
+// Plays up to eight games from `board` in lockstep, one per 32-bit lane, with every piece's
+// progress held as a vector over the lanes. All games move the same side at the same time,
+// so only the choice of piece differs between lanes. Finished games are masked out and
+// keep their final state. Returns how many of the first `lanes` games player 0 won.
+__attribute__((target("avx2")))
+int playoutBatchAvx2(const Board& board, int lanes, Xoshiro256& rng, const std::int32_t* table) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i turned = _mm256_set1_epi32(Board::PROGRESS_TURNED);
+    const __m256i home = _mm256_set1_epi32(Board::PROGRESS_RETURNED);
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+
+    __m256i progress[Board::NUM_PIECES];
+    int returned_now[2] = {0, 0};
+    for (int id = 0; id < Board::NUM_PIECES; ++id) {
+        progress[id] = _mm256_set1_epi32(board.getProgress(id));
+        if (board.getProgress(id) == Board::PROGRESS_RETURNED) ++returned_now[id / 5];
+    }
+    __m256i returned[2] = {_mm256_set1_epi32(returned_now[0]), _mm256_set1_epi32(returned_now[1])};
+
+    // Lanes past `lanes` never start
+    __m256i active = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    if (returned_now[0] >= 4 || returned_now[1] >= 4) active = zero;
+
+    int player = board.getCurrentPlayer();
+    while (!_mm256_testz_si256(active, active)) {
+        int own = player * 5;
+        int opponent = (1 - player) * 5;
+
+        // Legal pieces and how many there are in each lane
+        __m256i legal[5];
+        __m256i count = zero;
+        for (int k = 0; k < 5; ++k) {
+            legal[k] = _mm256_xor_si256(_mm256_cmpeq_epi32(progress[own + k], home), _mm256_set1_epi32(-1));
+            count = _mm256_sub_epi32(count, legal[k]);
+        }
+
+        // A 16-bit random number per lane, scaled into [0, count)
+        std::uint64_t low = rng.next();
+        std::uint64_t high = rng.next();
+        __m256i random = _mm256_cvtepu16_epi32(_mm_set_epi64x(static_cast<long long>(high), static_cast<long long>(low)));
+        __m256i pick = _mm256_srli_epi32(_mm256_mullo_epi32(random, count), 16);
+
+        // The picked piece is the legal one preceded by exactly `pick` legal pieces
+        __m256i seen = zero;
+        __m256i track = zero;  // Track number 1-5 of the chosen piece
+        __m256i from = zero;   // Its progress before the move
+        __m256i chosen[5];
+        for (int k = 0; k < 5; ++k) {
+            chosen[k] = _mm256_and_si256(legal[k], _mm256_cmpeq_epi32(seen, pick));
+            seen = _mm256_sub_epi32(seen, legal[k]);
+            track = _mm256_blendv_epi8(track, _mm256_set1_epi32(k + 1), chosen[k]);
+            from = _mm256_blendv_epi8(from, progress[own + k], chosen[k]);
+        }
+
+        // Opponents standing on the chosen piece's lane: bit m for the one on track m+1
+        __m256i occupancy = zero;
+        for (int m = 0; m < 5; ++m) {
+            __m256i p = progress[opponent + m];
+            __m256i position = _mm256_min_epi32(p, _mm256_sub_epi32(home, p));
+            __m256i on_lane = _mm256_cmpeq_epi32(position, track);
+            occupancy = _mm256_or_si256(occupancy, _mm256_and_si256(on_lane, _mm256_set1_epi32(1 << m)));
+        }
+
+        // index = ((own + track - 1) * 13 + from) * 32 + occupancy
+        __m256i piece = _mm256_add_epi32(_mm256_set1_epi32(own - 1), track);
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(piece, _mm256_set1_epi32(Board::PROGRESS_RETURNED + 1)), from);
+        index = _mm256_add_epi32(_mm256_slli_epi32(index, 5), occupancy);
+        __m256i transition = _mm256_mask_i32gather_epi32(zero, table, index, active, 4);
+        __m256i destination = _mm256_and_si256(transition, byte_mask);
+        __m256i resets = _mm256_srli_epi32(transition, 8);
+
+        for (int k = 0; k < 5; ++k) {
+            progress[own + k] = _mm256_blendv_epi8(progress[own + k], destination, _mm256_and_si256(chosen[k], active));
+        }
+        // Jumped opponents go back to the start of their current leg
+        for (int m = 0; m < 5; ++m) {
+            __m256i bit = _mm256_set1_epi32(1 << m);
+            __m256i jumped = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_and_si256(resets, bit), bit), active);
+            __m256i leg_start = _mm256_and_si256(_mm256_cmpgt_epi32(progress[opponent + m], _mm256_set1_epi32(5)), turned);
+            progress[opponent + m] = _mm256_blendv_epi8(progress[opponent + m], leg_start, jumped);
+        }
+
+        __m256i came_home = _mm256_and_si256(_mm256_cmpeq_epi32(destination, home), active);
+        returned[player] = _mm256_sub_epi32(returned[player], came_home);
+        __m256i finished = _mm256_or_si256(_mm256_cmpgt_epi32(returned[0], three),
+                                           _mm256_cmpgt_epi32(returned[1], three));
+        active = _mm256_andnot_si256(finished, active);
+        player = 1 - player;
+    }
+
+    __m256i won = _mm256_cmpgt_epi32(returned[0], three);
+    int lane_mask = _mm256_movemask_ps(_mm256_castsi256_ps(won)) & ((1 << lanes) - 1);
+    return std::popcount(static_cast<unsigned>(lane_mask));
+}
+
+__attribute__((target("avx2")))
+int countPlayoutWinsAvx2(const Board& board, int num_playouts, Xoshiro256& rng) {
+    const std::int32_t* table = flatMoveTable().data();
+    int wins = 0;
+    for (int done = 0; done < num_playouts; done += LANES) {
+        wins += playoutBatchAvx2(board, std::min(LANES, num_playouts - done), rng, table);
+    }
+    return wins;
+}
+
+#endif // SQUADRO_HAS_AVX2_PLAYOUTS
+
+} // namespace
+
+int countPlayoutWins(const Board& board, int num_playouts, Xoshiro256& rng) {
+#ifdef SQUADRO_HAS_AVX2_PLAYOUTS
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    if (has_avx2) return countPlayoutWinsAvx2(board, num_playouts, rng);
+#endif
+    return countPlayoutWinsScalar(board, num_playouts, rng);
+}
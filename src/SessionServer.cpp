@@ -0,0 +1,240 @@
+#include "SessionServer.hpp"
+#include "EngineData.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include "httplib.h"
+#include "json.hpp"
+using json = nlohmann::json;
+
+namespace {
+
+void setError(httplib::Response& res, int status, const std::string& error) {
+    res.status = status;
+    res.set_content(json{{"status", false}, {"error", error}}.dump(), "application/json");
+}
+
+} // namespace
+
+SessionServer::SessionServer(const std::string& host, int send_port, int receive_port,
+                             size_t num_threads, size_t tt_size_mb, const TimeControl& time_control,
+                             const HttpClientOptions& http)
+    : host_ip(host),
+      port_to_send(send_port),
+      port_to_receive(receive_port),
+      http_options(http),
+      time_control(time_control),
+      tt(std::make_shared<TranspositionTable>(tt_size_mb)),
+      tablebase(loadOptional<Tablebase>(TABLEBASE_PATH, "endgame tablebase")),
+      opening_book(loadOptional<OpeningBook>(OPENING_BOOK_PATH, "opening book")),
+      svr(std::make_unique<httplib::Server>()),
+      pool(num_threads)
+{
+    std::cout << "Session server initializing with " << pool.size() << " search threads and a "
+              << tt_size_mb << " MB transposition table shared by all games.\n";
+    std::cout << "Time control: " << time_control << ".\n";
+
+    svr->Post("/games/:id/start", [this](const httplib::Request& req, httplib::Response& res) {
+        const std::string& id = req.path_params.at("id");
+        int player;
+        try {
+            player = json::parse(req.body).at("player");
+        } catch (const std::exception& e) {
+            setError(res, 400, e.what());
+            return;
+        }
+        if (player != 1 && player != 2) {
+            setError(res, 400, "player must be 1 or 2");
+            return;
+        }
+
+        auto game = std::make_shared<Game>(player, tt, this->time_control, host_ip, port_to_send, http_options);
+        game->ai.setTablebase(tablebase);
+        game->ai.setOpeningBook(opening_book);
+        {
+            std::lock_guard<std::mutex> lock(games_mutex);
+            if (!games.emplace(id, game).second) {
+                setError(res, 409, "game already exists");
+                return;
+            }
+        }
+        std::cout << "Game " << id << ": started as Player " << player << ".\n";
+        res.set_content("{\"status\": true}", "application/json");
+
+        // Player 1 moves first
+        if (player == 1) scheduleMove(id, std::move(game));
+    });
+
+    svr->Post("/games/:id", [this](const httplib::Request& req, httplib::Response& res) {
+        const std::string& id = req.path_params.at("id");
+        auto game = findGame(id);
+        if (!game) {
+            setError(res, 404, "unknown game");
+            return;
+        }
+
+        bool game_over;
+        {
+            std::lock_guard<std::mutex> lock(game->mutex);
+            if (game->board.isGameOver()) {
+                setError(res, 409, "game is over");
+                return;
+            }
+            int current_external_player = game->board.getCurrentPlayer() + 1;
+            if (current_external_player == game->ai_player) {
+                res.set_content("{\"status\": true, \"info\": \"ignored_as_not_opponent_turn\"}", "application/json");
+                return;
+            }
+
+            int gui_move_id;
+            try {
+                json data = json::parse(req.body);
+                gui_move_id = data.at("move");
+                if (data.at("player") != current_external_player) throw std::invalid_argument("wrong player");
+            } catch (const std::exception& e) {
+                setError(res, 400, e.what());
+                return;
+            }
+            if (gui_move_id < 1 || gui_move_id > 5 || !(game->board.getLegalMoveMask() & (1 << (gui_move_id - 1)))) {
+                setError(res, 400, "illegal move");
+                return;
+            }
+
+            game->board.makeMove((gui_move_id - 1) + (current_external_player - 1) * 5);
+            game_over = game->board.isGameOver();
+        }
+        res.set_content("{\"status\": true}", "application/json");
+
+        if (game_over) {
+            std::cout << "Game " << id << ": over, the opponent won.\n";
+            removeGame(id);
+        } else {
+            scheduleMove(id, std::move(game));
+        }
+    });
+
+    svr->Delete("/games/:id", [this](const httplib::Request& req, httplib::Response& res) {
+        // A search still running for the game is stopped; its move is then not sent
+        if (auto game = findGame(req.path_params.at("id"))) {
+            game->abandoned.store(true);
+            game->ai.stop();
+        }
+        removeGame(req.path_params.at("id"));
+        res.set_content("{\"status\": true}", "application/json");
+    });
+}
+
+SessionServer::~SessionServer() {
+    stop();
+    // The pool runs every queued search before it goes, so make them all return at once
+    std::lock_guard<std::mutex> lock(games_mutex);
+    for (auto& [id, game] : games) {
+        game->abandoned.store(true);
+        game->ai.stop();
+    }
+}
+
+void SessionServer::run() {
+    std::cout << "Session server listening on http://0.0.0.0:" << port_to_receive << std::endl;
+    if (!svr->listen("0.0.0.0", port_to_receive)) {
+        throw std::runtime_error("Failed to start HTTP listening server on port " + std::to_string(port_to_receive));
+    }
+}
+
+void SessionServer::stop() {
+    if (svr->is_running()) svr->stop();
+}
+
+std::shared_ptr<SessionServer::Game> SessionServer::findGame(const std::string& id) {
+    std::lock_guard<std::mutex> lock(games_mutex);
+    auto it = games.find(id);
+    return it == games.end() ? nullptr : it->second;
+}
+
+void SessionServer::removeGame(const std::string& id) {
+    std::lock_guard<std::mutex> lock(games_mutex);
+    games.erase(id);
+}
+
+void SessionServer::scheduleMove(const std::string& id, std::shared_ptr<Game> game) {
+    // Submitted from a server thread, so it joins the back of the pool's shared FIFO queue
+    waiting_games.fetch_add(1);
+    pool.submit([this, id, game = std::move(game), queued_at = std::chrono::steady_clock::now()]() {
+        try {
+            playMove(id, *game, queued_at);
+        } catch (const std::exception& e) {
+            std::cerr << "Game " << id << ": " << e.what() << '\n';
+        }
+        waiting_games.fetch_sub(1);
+    });
+}
+
+void SessionServer::endSearch() {
+    // A round is one search per game in play; only then are the table's entries a move older
+    size_t games_in_play;
+    {
+        std::lock_guard<std::mutex> lock(games_mutex);
+        games_in_play = std::max<size_t>(games.size(), 1);
+    }
+    size_t done = searches_this_round.fetch_add(1) + 1;
+    if (done >= games_in_play && searches_this_round.compare_exchange_strong(done, 0)) tt->newSearch();
+}
+
+MoveBudget SessionServer::shareBudget(MoveBudget budget, std::chrono::duration<double> waited) const {
+    // Waiting for a free thread used up part of this move's time. With more games waiting
+    // than threads, the rest is split so the searches queued behind this one fit in it too.
+    size_t threads = pool.size();
+    size_t waiting = waiting_games.load();
+    double share = waiting > threads ? static_cast<double>(threads) / waiting : 1.0;
+
+    const std::chrono::duration<double> min_time = MIN_SEARCH_TIME;
+    budget.optimum = std::max((budget.optimum - waited) * share, min_time);
+    budget.maximum = std::max((budget.maximum - waited) * share, min_time);
+    return budget;
+}
+
+void SessionServer::playMove(const std::string& id, Game& game, std::chrono::steady_clock::time_point queued_at) {
+    Board board_copy;
+    {
+        std::lock_guard<std::mutex> lock(game.mutex);
+        if (game.abandoned.load() || game.board.isGameOver() || (game.board.getCurrentPlayer() + 1) != game.ai_player) return;
+        board_copy = game.board;
+    }
+
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - queued_at;
+    MoveBudget budget = shareBudget(game.time_manager.nextMove(), waited);
+    int best_move_id = game.ai.findBestMove(board_copy, budget);
+    endSearch();
+    if (best_move_id == -1) {
+        std::cerr << "Game " << id << ": AI could not find a legal move.\n";
+        return;
+    }
+    if (game.abandoned.load()) return;
+
+    // Played before it is sent, so the opponent's reply cannot arrive ahead of it
+    bool game_over;
+    {
+        std::lock_guard<std::mutex> lock(game.mutex);
+        game.board.makeMove(best_move_id);
+        game_over = game.board.isGameOver();
+    }
+
+    int gui_move_to_send = (best_move_id % 5) + 1;
+    std::cout << "Game " << id << ": AI chose pawn " << gui_move_to_send << " after waiting "
+              << waited.count() << "s for a thread and searching for up to " << budget.maximum.count()
+              << "s." << std::endl;
+    if (!game.sender.send("/games/" + id, json{{"move", gui_move_to_send}}.dump())) {
+        // The sender has already retried with backoff. No opponent move can follow one the GUI
+        // never took, so the game could only hang: it is dropped instead.
+        std::cerr << "Game " << id << ": our move could not be sent, abandoning the game.\n";
+        game.abandoned.store(true);
+        removeGame(id);
+        return;
+    }
+    game.time_manager.moveMade(std::chrono::steady_clock::now() - queued_at);
+
+    if (game_over) {
+        std::cout << "Game " << id << ": over, we won.\n";
+        removeGame(id);
+    }
+}
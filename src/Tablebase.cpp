@@ -0,0 +1,226 @@
+#include "Tablebase.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+// On-disk layout: this header followed by one int8 distance per position, in index order
+struct FileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t max_unfinished;
+    std::uint32_t reserved;
+    std::uint64_t entries;
+};
+
+constexpr char FILE_MAGIC[4] = {'S', 'Q', 'T', 'B'};
+constexpr std::uint32_t FILE_VERSION = 2; // 2: UNKNOWN marks positions beyond the horizon
+
+std::uint64_t power(std::uint64_t base, int exponent) {
+    std::uint64_t result = 1;
+    while (exponent-- > 0) result *= base;
+    return result;
+}
+
+} // namespace
+
+std::uint64_t Tablebase::buildClasses(int max_unfinished) {
+    if (max_unfinished < 2 || max_unfinished > 5) {
+        throw std::out_of_range("Tablebase pieces per side must be between 2 and 5");
+    }
+    this->max_unfinished = max_unfinished;
+    classes.clear();
+    class_of.fill(-1);
+
+    // Classes are laid out by the total number of pieces left, fewest first
+    std::uint64_t offset = 0;
+    for (int total = 4; total <= 2 * max_unfinished; ++total) {
+        for (int mask0 = 0; mask0 < 32; ++mask0) {
+            for (int mask1 = 0; mask1 < 32; ++mask1) {
+                int count0 = std::popcount(static_cast<unsigned>(mask0));
+                int count1 = std::popcount(static_cast<unsigned>(mask1));
+                if (count0 < 2 || count1 < 2 || count0 > max_unfinished || count1 > max_unfinished) continue;
+                if (count0 + count1 != total) continue;
+
+                class_of[mask0 * 32 + mask1] = static_cast<std::int32_t>(classes.size());
+                classes.push_back({{static_cast<std::uint8_t>(mask0), static_cast<std::uint8_t>(mask1)}, offset});
+                offset += 2 * power(PROGRESS_RADIX, total);
+            }
+        }
+    }
+    return offset;
+}
+
+bool Tablebase::indexOf(const Board& board, std::uint64_t& index) const {
+    int unfinished[2] = {0, 0};
+    for (int id = 0; id < Board::NUM_PIECES; ++id) {
+        if (board.getProgress(id) != Board::PROGRESS_RETURNED) unfinished[id / 5] |= 1 << (id % 5);
+    }
+    std::int32_t number = class_of[unfinished[0] * 32 + unfinished[1]];
+    if (number < 0) return false;
+
+    std::uint64_t digits = 0;
+    std::uint64_t side_size = 1;
+    for (int id = 0; id < Board::NUM_PIECES; ++id) {
+        if (unfinished[id / 5] & (1 << (id % 5))) {
+            digits = digits * PROGRESS_RADIX + board.getProgress(id);
+            side_size *= PROGRESS_RADIX;
+        }
+    }
+    index = classes[number].offset + board.getCurrentPlayer() * side_size + digits;
+    return true;
+}
+
+Board Tablebase::positionAt(std::uint64_t index) const {
+    auto next = std::upper_bound(classes.begin(), classes.end(), index,
+        [](std::uint64_t value, const PositionClass& c) { return value < c.offset; });
+    const PositionClass& position_class = *(next - 1);
+
+    int count = std::popcount(static_cast<unsigned>(position_class.unfinished[0]))
+              + std::popcount(static_cast<unsigned>(position_class.unfinished[1]));
+    std::uint64_t side_size = power(PROGRESS_RADIX, count);
+    std::uint64_t rest = index - position_class.offset;
+    int player = static_cast<int>(rest / side_size);
+    rest %= side_size;
+
+    std::array<int, Board::NUM_PIECES> progress;
+    for (int id = Board::NUM_PIECES - 1; id >= 0; --id) {
+        if (position_class.unfinished[id / 5] & (1 << (id % 5))) {
+            progress[id] = static_cast<int>(rest % PROGRESS_RADIX);
+            rest /= PROGRESS_RADIX;
+        } else {
+            progress[id] = Board::PROGRESS_RETURNED;
+        }
+    }
+    return Board::fromProgress(progress, player);
+}
+
+void Tablebase::generate(int max_unfinished, std::ostream* log) {
+    file.reset();
+    owned.assign(buildClasses(max_unfinished), UNKNOWN);
+    entries = owned.data();
+    entry_count = owned.size();
+    std::int8_t* distances = owned.data();
+
+    // Sweep n finds the wins in n plies (odd n) or the losses in n plies (even n). A win in n
+    // needs a move to a loss in n-1; a loss in n needs every move to lead to a win in at most
+    // n-1. Values written during a sweep never satisfy its own test, so updating in place is safe.
+    // Unresolved positions are found by rescanning for UNKNOWN rather than kept in a list,
+    // which would take eight times the table's memory.
+    bool converged = false;
+    for (int n = 1; n <= MAX_DISTANCE; ++n) {
+        bool seeking_win = n % 2 == 1;
+        std::size_t found = 0;
+        std::size_t unresolved = 0;
+        for (std::uint64_t index = 0; index < entry_count; ++index) {
+            if (distances[index] != UNKNOWN) continue;
+            Board board = positionAt(index);
+            int mask = board.getLegalMoveMask();
+            int first_id = board.getCurrentPlayer() * 5;
+
+            bool resolved = !seeking_win;
+            for (int k = 0; k < 5; ++k) {
+                if (!(mask & (1 << k))) continue;
+                Board child = board;
+                child.makeMove(first_id + k);
+
+                bool child_lost = true; // A move that ends the game is a loss in 0 for the opponent
+                bool child_won = false;
+                if (!child.isGameOver()) {
+                    std::uint64_t child_index;
+                    indexOf(child, child_index);
+                    int child_distance = distances[child_index];
+                    child_lost = child_distance != UNKNOWN && child_distance < 0 && -child_distance <= n - 1;
+                    child_won = child_distance > 0 && child_distance <= n - 1;
+                }
+                if (seeking_win && child_lost) {
+                    resolved = true;
+                    break;
+                }
+                if (!seeking_win && !child_won) {
+                    resolved = false;
+                    break;
+                }
+            }
+
+            if (resolved) {
+                distances[index] = static_cast<std::int8_t>(seeking_win ? n : -n);
+                ++found;
+            } else {
+                ++unresolved;
+            }
+        }
+
+        if (log) {
+            *log << "Sweep " << n << ": " << found << (seeking_win ? " wins" : " losses")
+                 << ", " << unresolved << " positions unresolved.\n";
+        }
+        // With no results at this distance there can be none at any greater distance
+        if (found == 0 || unresolved == 0) {
+            converged = true;
+            break;
+        }
+    }
+
+    // Past the fixpoint, what is still unresolved can never be won or lost: a draw. Positions
+    // cut off by the int8 horizon instead stay UNKNOWN, so probes fall back to searching them.
+    std::size_t beyond_horizon = 0;
+    for (std::uint64_t index = 0; index < entry_count; ++index) {
+        if (distances[index] != UNKNOWN) continue;
+        if (converged) distances[index] = 0;
+        else ++beyond_horizon;
+    }
+    if (log && beyond_horizon > 0) {
+        *log << beyond_horizon << " positions are unresolved beyond " << MAX_DISTANCE
+             << " plies and are left out of the table.\n";
+    }
+}
+
+void Tablebase::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Cannot open tablebase file for writing: " + path);
+
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+    header.version = FILE_VERSION;
+    header.max_unfinished = static_cast<std::uint32_t>(max_unfinished);
+    header.entries = entry_count;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries), static_cast<std::streamsize>(entry_count));
+    if (!out) throw std::runtime_error("Failed writing tablebase file: " + path);
+}
+
+void Tablebase::load(const std::string& path) {
+    auto mapped = std::make_unique<MappedFile>(path);
+
+    FileHeader header{};
+    if (mapped->size() < sizeof(header)) throw std::runtime_error("Not a Squadro tablebase file: " + path);
+    std::memcpy(&header, mapped->data(), sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION) {
+        throw std::runtime_error("Not a Squadro tablebase file: " + path);
+    }
+
+    std::uint64_t total = buildClasses(static_cast<int>(header.max_unfinished));
+    if (header.entries != total || mapped->size() != sizeof(header) + total) {
+        entries = nullptr;
+        entry_count = 0;
+        throw std::runtime_error("Tablebase file has the wrong size: " + path);
+    }
+
+    owned.clear();
+    file = std::move(mapped);
+    entries = reinterpret_cast<const std::int8_t*>(file->data() + sizeof(header));
+    entry_count = total;
+}
+
+bool Tablebase::probe(const Board& board, int& distance) const {
+    std::uint64_t index;
+    if (entry_count == 0 || !indexOf(board, index)) return false;
+    if (entries[index] == UNKNOWN) return false;
+    distance = entries[index];
+    return true;
+}
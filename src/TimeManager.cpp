@@ -0,0 +1,72 @@
+#include "TimeManager.hpp"
+#include <algorithm>
+#include <ostream>
+
+std::ostream& operator<<(std::ostream& out, const TimeControl& control) {
+    if (control.game_time.count() > 0) {
+        out << control.game_time.count() << "s + " << control.increment.count() << "s per move";
+    } else {
+        out << control.move_time.count() << "s per move";
+    }
+    return out << " (" << control.move_overhead.count() << "s overhead)";
+}
+
+TimeManager::TimeManager(const TimeControl& control)
+    : time_control(control),
+      clock(control.game_time)
+{
+}
+
+MoveBudget TimeManager::nextMove() const {
+    using seconds = std::chrono::duration<double>;
+    if (time_control.game_time <= seconds::zero()) {
+        seconds limit = std::max(time_control.move_time - time_control.move_overhead, seconds::zero());
+        return {limit, limit};
+    }
+
+    seconds left = std::max(clock - time_control.move_overhead, seconds::zero());
+    seconds optimum = left / std::max(time_control.moves_to_go, 1) + time_control.increment * INCREMENT_SHARE;
+    seconds maximum = std::min(optimum * MAX_OVER_OPTIMUM, left * MAX_CLOCK_SHARE + time_control.increment * INCREMENT_SHARE);
+    maximum = std::min(maximum, left);
+    return {std::min(optimum, maximum), maximum};
+}
+
+void TimeManager::moveMade(std::chrono::duration<double> used) {
+    if (time_control.game_time <= std::chrono::duration<double>::zero()) return;
+    clock = clock - used + time_control.increment;
+}
+
+SearchTimer::SearchTimer(const MoveBudget& budget, std::chrono::steady_clock::time_point start)
+    : budget(budget),
+      start(start),
+      last_completed(start)
+{
+}
+
+void SearchTimer::iterationCompleted(int move) {
+    auto now = std::chrono::steady_clock::now();
+    previous_iteration = last_iteration;
+    last_iteration = now - last_completed;
+    last_completed = now;
+
+    instability *= INSTABILITY_DECAY;
+    if (best_move != -1 && move != best_move) instability += 1.0;
+    best_move = move;
+}
+
+std::chrono::duration<double> SearchTimer::predictedIteration() const {
+    double branching = DEFAULT_BRANCHING;
+    if (previous_iteration.count() > 0) {
+        branching = std::clamp(last_iteration / previous_iteration, 1.0, MAX_BRANCHING);
+    }
+    return last_iteration * branching;
+}
+
+bool SearchTimer::shouldStartIteration() const {
+    if (best_move == -1) return true; // Every search completes one iteration, whatever its budget
+    auto spent = elapsed();
+    if (spent >= budget.maximum) return false;
+
+    auto target = std::min(budget.optimum * (1.0 + INSTABILITY_WEIGHT * instability), budget.maximum);
+    return spent + predictedIteration() <= target;
+}
@@ -0,0 +1,141 @@
+#include "TranspositionTable.hpp"
+#include <bit>
+#include <functional>
+#include <thread>
+
+TranspositionTable::TranspositionTable(std::size_t size_mb)
+    : stats(std::make_unique<StatStripe[]>(STAT_STRIPES))
+{
+    resize(size_mb);
+}
+
+void TranspositionTable::resize(std::size_t size_mb) {
+    // Round the cluster count down to a power of two so indexing is a mask
+    std::size_t requested = (size_mb * 1024 * 1024) / sizeof(Cluster);
+    std::size_t count = std::bit_floor(requested > 0 ? requested : std::size_t{1});
+    clusters = std::make_unique<Cluster[]>(count);
+    index_mask = count - 1;
+    generation.store(0, std::memory_order_relaxed);
+    resetStats();
+}
+
+void TranspositionTable::clear() {
+    for (std::uint64_t i = 0; i <= index_mask; ++i) {
+        for (Slot& slot : clusters[i].slots) {
+            slot.key_xor_data.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation.store(0, std::memory_order_relaxed);
+    resetStats();
+}
+
+void TranspositionTable::newSearch() {
+    generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t TranspositionTable::pack(int depth, Bound bound, int score, int move, std::uint8_t generation) {
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(score))
+         | static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << 32
+         | static_cast<std::uint64_t>(static_cast<std::uint8_t>(bound)) << 40
+         | static_cast<std::uint64_t>(static_cast<std::uint8_t>(move)) << 48
+         | static_cast<std::uint64_t>(generation) << 56;
+}
+
+TTEntry TranspositionTable::unpack(std::uint64_t key, std::uint64_t data) {
+    return {key,
+            static_cast<std::int32_t>(static_cast<std::uint32_t>(data)),
+            static_cast<std::int8_t>(data >> 32),
+            static_cast<Bound>(static_cast<std::uint8_t>(data >> 40)),
+            static_cast<std::int8_t>(data >> 48),
+            static_cast<std::uint8_t>(data >> 56)};
+}
+
+TTEntry TranspositionTable::read(const Slot& slot) {
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    std::uint64_t key = slot.key_xor_data.load(std::memory_order_relaxed) ^ data;
+    return unpack(key, data);
+}
+
+TranspositionTable::StatStripe& TranspositionTable::localStripe(StatStripe* stripes) {
+    thread_local const std::size_t stripe = std::hash<std::thread::id>{}(std::this_thread::get_id()) % STAT_STRIPES;
+    return stripes[stripe];
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TTEntry& entry) {
+    StatStripe& counters = localStripe(stats.get());
+    counters.probes.fetch_add(1, std::memory_order_relaxed);
+    for (const Slot& slot : clusterFor(key).slots) {
+        TTEntry candidate = read(slot);
+        if (candidate.key == key && candidate.bound != Bound::None) {
+            counters.hits.fetch_add(1, std::memory_order_relaxed);
+            entry = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, int depth, Bound bound, int score, int move) {
+    Cluster& cluster = clusterFor(key);
+    std::uint8_t current = generation.load(std::memory_order_relaxed);
+
+    // Prefer the slot already holding this position, else the least valuable one
+    Slot* victim = &cluster.slots[0];
+    TTEntry victim_entry = read(*victim);
+    int victim_worth = 0;
+    for (int i = 0; i < CLUSTER_SIZE; ++i) {
+        TTEntry candidate = read(cluster.slots[i]);
+        if (candidate.key == key || candidate.bound == Bound::None) {
+            victim = &cluster.slots[i];
+            victim_entry = candidate;
+            break;
+        }
+        int age = static_cast<std::uint8_t>(current - candidate.generation);
+        int worth = candidate.depth - 4 * age;
+        if (i == 0 || worth < victim_worth) {
+            victim = &cluster.slots[i];
+            victim_entry = candidate;
+            victim_worth = worth;
+        }
+    }
+
+    StatStripe& counters = localStripe(stats.get());
+    if (victim_entry.key == key && victim_entry.bound != Bound::None) {
+        // Keep a deeper result for the same position unless this one is exact
+        if (bound != Bound::Exact && depth < victim_entry.depth && victim_entry.generation == current) return;
+        if (move < 0) move = victim_entry.move;
+    } else if (victim_entry.bound != Bound::None) {
+        counters.replacements.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    counters.stores.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t data = pack(depth, bound, score, move, current);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+}
+
+TranspositionTable::Stats TranspositionTable::getStats() const {
+    Stats total;
+    for (int i = 0; i < STAT_STRIPES; ++i) {
+        total.probes += stats[i].probes.load(std::memory_order_relaxed);
+        total.hits += stats[i].hits.load(std::memory_order_relaxed);
+        total.stores += stats[i].stores.load(std::memory_order_relaxed);
+        total.replacements += stats[i].replacements.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void TranspositionTable::resetStats() {
+    for (int i = 0; i < STAT_STRIPES; ++i) {
+        stats[i].probes.store(0, std::memory_order_relaxed);
+        stats[i].hits.store(0, std::memory_order_relaxed);
+        stats[i].stores.store(0, std::memory_order_relaxed);
+        stats[i].replacements.store(0, std::memory_order_relaxed);
+    }
+}
+
+double TranspositionTable::hitRate() const {
+    Stats total = getStats();
+    return total.probes == 0 ? 0.0 : static_cast<double>(total.hits) / static_cast<double>(total.probes);
+}
@@ -1,26 +1,71 @@
 #include "GameController.hpp"
+#include "SessionServer.hpp"
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <thread> // Include the thread library for parallel execution
+#include <vector>
+
+namespace {
+
+// Takes the time control options out of the arguments, leaving the positional ones in place
+TimeControl parseTimeControl(std::vector<char*>& args) {
+    TimeControl control;
+    std::vector<char*> rest;
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::string option = args[i];
+        bool takes_value = option == "--move-time" || option == "--clock" || option == "--increment"
+                        || option == "--overhead" || option == "--moves-to-go";
+        if (!takes_value) {
+            rest.push_back(args[i]);
+            continue;
+        }
+        if (i + 1 == args.size()) throw std::invalid_argument(option + " requires a value");
+        std::string value = args[++i];
+
+        if (option == "--moves-to-go") {
+            control.moves_to_go = std::stoi(value);
+            continue;
+        }
+        std::chrono::duration<double> seconds{std::stod(value)};
+        if (option == "--move-time") control.move_time = seconds;
+        else if (option == "--clock") control.game_time = seconds;
+        else if (option == "--increment") control.increment = seconds;
+        else control.move_overhead = seconds;
+    }
+    args = std::move(rest);
+    return control;
+}
+
+} // namespace
 
 int main(int argc, char* argv[]) {
     try {
+        std::vector<char*> args(argv, argv + argc);
+        TimeControl time_control = parseTimeControl(args);
+        argc = static_cast<int>(args.size());
+        argv = args.data();
+
         std::string server_host = "127.0.0.1";
         int send_port = 8081;
         int receive_port = 9081;
         int ai_player_id = 1;
 
         if (argc < 2) {
-            std::cerr << "Usage: " << argv[0] << " --manual <server_ip> <send_port> <receive_port> <player_id>" << std::endl;
+            std::cerr << "Usage: " << argv[0] << " --manual <server_ip> <send_port> <receive_port> <player_id> [minimax|mcts]" << std::endl;
+            std::cerr << "Or: " << argv[0] << " --server <server_ip> <send_port> <receive_port> [threads] [tt_mb]" << std::endl;
             std::cerr << "Or: " << argv[0] << " --demo" << std::endl;
+            std::cerr << "Time control options, in seconds: --move-time <s> (default 10), or --clock <s> "
+                      << "[--increment <s>] [--moves-to-go <n>] for a game clock; --overhead <s> (default 0.5)" << std::endl;
             return 1;
         }
 
         std::string mode = argv[1];
 
         if (mode == "--manual") {
-            if (argc != 6) {
-                std::cerr << "Error: --manual mode requires 4 arguments: <server_ip> <send_port> <receive_port> <player_id>" << std::endl;
+            if (argc != 6 && argc != 7) {
+                std::cerr << "Error: --manual mode requires 4 arguments: <server_ip> <send_port> <receive_port> <player_id>"
+                          << ", optionally followed by the engine (minimax or mcts)" << std::endl;
                 return 1;
             }
             server_host = argv[2];
@@ -33,10 +78,37 @@ int main(int argc, char* argv[]) {
                 return 1;
             }
 
+            auto engine = GameController::EngineType::Minimax;
+            if (argc == 7) {
+                std::string engine_name = argv[6];
+                if (engine_name == "mcts") {
+                    engine = GameController::EngineType::Mcts;
+                } else if (engine_name != "minimax") {
+                    std::cerr << "Error: Engine must be minimax or mcts." << std::endl;
+                    return 1;
+                }
+            }
+
             std::cout << "Starting in manual mode for Player " << ai_player_id << "..." << std::endl;
-            GameController controller(server_host, send_port, receive_port, ai_player_id);
+            GameController controller(server_host, send_port, receive_port, ai_player_id, engine, time_control);
             controller.run();
 
+        } else if (mode == "--server") {
+            if (argc < 5 || argc > 7) {
+                std::cerr << "Error: --server mode requires 3 arguments: <server_ip> <send_port> <receive_port>"
+                          << ", optionally followed by the number of search threads and the table size in MB" << std::endl;
+                return 1;
+            }
+            server_host = argv[2];
+            send_port = std::stoi(argv[3]);
+            receive_port = std::stoi(argv[4]);
+            size_t num_threads = argc > 5 ? std::stoul(argv[5]) : 0;
+            size_t tt_size_mb = argc > 6 ? std::stoul(argv[6]) : 256;
+
+            std::cout << "Starting in multi-game server mode..." << std::endl;
+            SessionServer server(server_host, send_port, receive_port, num_threads, tt_size_mb, time_control);
+            server.run();
+
         } else if (mode == "--demo") {
             std::cout << "Starting in demo mode with two AI players..." << std::endl;
             
@@ -54,8 +126,10 @@ int main(int argc, char* argv[]) {
 
             // This is the new, multithreaded solution.
             // Create the controller objects on the heap so they live as long as the threads.
-            auto controller1 = std::make_unique<GameController>(player1_host, player1_send_port, player1_receive_port, player1_id);
-            auto controller2 = std::make_unique<GameController>(player2_host, player2_send_port, player2_receive_port, player2_id);
+            auto controller1 = std::make_unique<GameController>(player1_host, player1_send_port, player1_receive_port, player1_id,
+                                                              GameController::EngineType::Minimax, time_control);
+            auto controller2 = std::make_unique<GameController>(player2_host, player2_send_port, player2_receive_port, player2_id,
+                                                              GameController::EngineType::Minimax, time_control);
             
             // Start each controller's run method in a separate thread.
             std::cout << "Launching Player 1 and Player 2 threads..." << std::endl;
@@ -68,7 +142,7 @@ int main(int argc, char* argv[]) {
 
             std::cout << "Both AI players have finished their game." << std::endl;
         } else {
-            std::cerr << "Error: Unknown mode. Use --manual or --demo." << std::endl;
+            std::cerr << "Error: Unknown mode. Use --manual, --server or --demo." << std::endl;
             return 1;
         }
     } catch (const std::exception& e) {
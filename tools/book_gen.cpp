@@ -0,0 +1,67 @@
+#include "MinimaxAI.hpp"
+#include "OpeningBook.hpp"
+#include "Playout.hpp"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Builds an opening book from engine self-play. In the first `book_plies` plies a random
+// move is played instead of the engine's with probability `explore`, so games branch out.
+// Usage: book_gen [output_path] [games] [book_plies] [ms_per_move] [explore]
+int main(int argc, char* argv[]) {
+    try {
+        std::string path = argc > 1 ? argv[1] : "squadro.book";
+        int games = argc > 2 ? std::stoi(argv[2]) : 100;
+        int book_plies = argc > 3 ? std::stoi(argv[3]) : 10;
+        std::chrono::duration<double> move_time{(argc > 4 ? std::stoi(argv[4]) : 100) / 1000.0};
+        double explore = argc > 5 ? std::stod(argv[5]) : 0.2;
+
+        MinimaxAI ai;
+        Xoshiro256& rng = threadRng();
+        std::map<std::pair<std::uint64_t, int>, OpeningBook::Entry> stats; // By (position key, move)
+
+        for (int game = 0; game < games; ++game) {
+            struct BookMove {
+                std::uint64_t key;
+                int move;
+                int player;
+            };
+            std::vector<BookMove> played;
+
+            Board board;
+            for (int ply = 0; !board.isGameOver(); ++ply) {
+                int move;
+                if (ply < book_plies && rng.below(1000) < explore * 1000) {
+                    auto moves = board.getLegalMoves();
+                    move = moves[rng.below(static_cast<std::uint32_t>(moves.size()))];
+                } else {
+                    move = ai.findBestMove(board, move_time);
+                }
+                if (ply < book_plies) played.push_back({board.getHash(), move, board.getCurrentPlayer()});
+                board.makeMove(move);
+            }
+
+            int winner = board.getWinner();
+            for (const BookMove& record : played) {
+                OpeningBook::Entry& entry = stats[{record.key, record.move}];
+                entry.key = record.key;
+                entry.move = record.move;
+                ++entry.games;
+                if (record.player == winner) ++entry.wins;
+            }
+            std::cerr << "Game " << (game + 1) << "/" << games << ": Player " << (winner + 1) << " won.\n";
+        }
+
+        std::vector<OpeningBook::Entry> entries;
+        for (const auto& [position, entry] : stats) entries.push_back(entry);
+        OpeningBook::save(path, entries);
+        std::cerr << "Wrote " << entries.size() << " book entries to " << path << ".\n";
+    } catch (const std::exception& e) {
+        std::cerr << "An unhandled exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "MctsAI.hpp"
+#include "Playout.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Single-threaded playouts per second of the batch kernel behind the minimax rollout blend
+// (AVX2 when the CPU has it) against randomPlayout one game at a time, with the share of
+// games player 0 won by each, which should agree
+void benchPlayouts(const Board& board, std::size_t playouts) {
+    Xoshiro256& rng = threadRng();
+    int count = static_cast<int>(playouts);
+
+    auto start = std::chrono::steady_clock::now();
+    int scalar_wins = 0;
+    for (int i = 0; i < count; ++i) {
+        if (randomPlayout(board, rng) == 0) ++scalar_wins;
+    }
+    std::chrono::duration<double> scalar_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    int batch_wins = countPlayoutWins(board, count, rng);
+    std::chrono::duration<double> batch_time = std::chrono::steady_clock::now() - start;
+
+    double scalar_rate = count / scalar_time.count();
+    double batch_rate = count / batch_time.count();
+    std::cout << std::fixed << "\n" << std::setw(18) << "kernel" << std::setw(16) << "playouts/s"
+              << std::setw(11) << "speedup" << std::setw(12) << "P1 wins" << "\n"
+              << std::setw(18) << "randomPlayout" << std::setw(16) << std::setprecision(0) << scalar_rate
+              << std::setw(10) << std::setprecision(2) << 1.0 << "x" << std::setw(11) << std::setprecision(1)
+              << 100.0 * scalar_wins / count << "%\n"
+              << std::setw(18) << "countPlayoutWins" << std::setw(16) << std::setprecision(0) << batch_rate
+              << std::setw(10) << std::setprecision(2) << batch_rate / scalar_rate << "x" << std::setw(11)
+              << std::setprecision(1) << 100.0 * batch_wins / count << "%\n";
+}
+
+} // namespace
+
+// Compares the playout kernels, then measures how tree-parallel MCTS playouts per second
+// scale with the number of threads.
+// Usage: mcts_bench [playouts_per_run] [max_threads]
+int main(int argc, char* argv[]) {
+    try {
+        std::size_t playouts = argc > 1 ? std::stoul(argv[1]) : 1000000;
+        std::size_t max_threads = argc > 2 ? std::stoul(argv[2]) : std::thread::hardware_concurrency();
+        if (max_threads == 0) max_threads = 1;
+
+        // 1, 2, 4, ... threads, always ending with max_threads itself
+        std::vector<std::size_t> thread_counts;
+        for (std::size_t threads = 1; threads < max_threads; threads *= 2) thread_counts.push_back(threads);
+        thread_counts.push_back(max_threads);
+
+        // Searches from the opening position, which has the longest playouts
+        Board board;
+        benchPlayouts(board, playouts);
+
+        const std::chrono::duration<double> no_time_limit{3600};
+        double single_thread_rate = 0.0;
+        std::vector<std::string> rows;
+        for (std::size_t threads : thread_counts) {
+            MctsAI ai(threads, 256, playouts);
+            auto start = std::chrono::steady_clock::now();
+            ai.findBestMove(board, no_time_limit);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            double rate = playouts / elapsed.count();
+            if (threads == 1) single_thread_rate = rate;
+
+            std::ostringstream row;
+            row << std::setw(8) << threads << std::setw(12) << std::fixed << std::setprecision(3) << elapsed.count()
+                << std::setw(16) << std::setprecision(0) << rate
+                << std::setw(10) << std::setprecision(2) << rate / single_thread_rate << "x";
+            rows.push_back(row.str());
+        }
+
+        std::cout << "\n" << std::setw(8) << "threads" << std::setw(12) << "seconds"
+                  << std::setw(16) << "playouts/s" << std::setw(11) << "speedup" << "\n";
+        for (const auto& row : rows) std::cout << row << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "An unhandled exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#include "Tablebase.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// Solves the endgame tablebase by retrograde analysis and writes it to disk.
+// Usage: tb_gen [output_path] [max_pieces_left_per_side]
+int main(int argc, char* argv[]) {
+    try {
+        std::string path = argc > 1 ? argv[1] : "squadro.tb";
+        int max_unfinished = argc > 2 ? std::stoi(argv[2]) : Tablebase::DEFAULT_MAX_UNFINISHED;
+
+        auto start = std::chrono::steady_clock::now();
+        Tablebase tablebase;
+        tablebase.generate(max_unfinished, &std::cout);
+        tablebase.save(path);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Wrote " << tablebase.size() << " positions to " << path
+                  << " in " << elapsed.count() << "s.\n";
+    } catch (const std::exception& e) {
+        std::cerr << "An unhandled exception occurred: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}